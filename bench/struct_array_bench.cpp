@@ -0,0 +1,535 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "describe.h"
+#include "struct_array.h"
+
+// struct_array (vectors, block and, from three fields on, grouped layouts) against an AoS
+// std::vector for 1 to SOA_MAX_BINDINGS - 1 fields of 4 and 32 bytes, and for a described record of
+// 32 fields of 4 bytes, at footprints from L1 resident to far beyond the last level cache. Every
+// benchmark reports the allocations per iteration, reserve_resize also the bytes allocated per
+// element.
+
+namespace
+{
+std::atomic<std::size_t> allocations{0U};
+std::atomic<std::size_t> allocated_bytes{0U};
+
+void *counted_allocate(const std::size_t size, const std::size_t alignment)
+{
+	allocations.fetch_add(1U, std::memory_order_relaxed);
+	allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+
+	void *p = alignment <= alignof(std::max_align_t)
+		? std::malloc(size == 0U ? 1U : size)
+		: std::aligned_alloc(alignment, (size + alignment - 1U) / alignment * alignment);
+	if (p == nullptr)
+		throw std::bad_alloc{};
+	return p;
+}
+} // namespace
+
+void *operator new(const std::size_t size)
+{
+	return counted_allocate(size, alignof(std::max_align_t));
+}
+
+void *operator new(const std::size_t size, const std::align_val_t alignment)
+{
+	return counted_allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept
+{
+	std::free(p);
+}
+
+namespace
+{
+// 32 byte field, ordered by its first word
+struct wide
+{
+	std::uint64_t words[4];
+};
+
+[[nodiscard]]
+auto key(const std::uint32_t x) noexcept -> std::uint64_t
+{
+	return x;
+}
+
+[[nodiscard]]
+auto key(const wide &x) noexcept -> std::uint64_t
+{
+	return x.words[0];
+}
+
+template <typename F>
+[[nodiscard]]
+auto make_field(const std::uint64_t seed) noexcept -> F
+{
+	if constexpr (std::is_same_v<F, wide>)
+		return {{seed, seed + 1U, seed + 2U, seed + 3U}};
+	else
+		return static_cast<F>(seed);
+}
+
+template <std::size_t N, typename F>
+struct record;
+
+template <typename F>
+struct record<1U, F>
+{
+	F a;
+};
+
+template <typename F>
+struct record<2U, F>
+{
+	F a, b;
+};
+
+template <typename F>
+struct record<3U, F>
+{
+	F a, b, c;
+};
+
+template <typename F>
+struct record<4U, F>
+{
+	F a, b, c, d;
+};
+
+// 32 fields of 4 bytes, described so it is not bound by SOA_MAX_BINDINGS
+template <>
+struct record<32U, std::uint32_t>
+{
+	std::uint32_t f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15,
+	              f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31;
+};
+
+using record32 = record<32U, std::uint32_t>;
+
+SOA_FIELDS(record32, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15,
+           f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31)
+
+template <typename T>
+struct record_traits;
+
+template <std::size_t N, typename F>
+struct record_traits<record<N, F>>
+{
+	static constexpr std::size_t fields = N;
+	using field_type = F;
+
+	[[nodiscard]]
+	static auto make(const std::uint64_t seed) noexcept -> record<N, F>
+	{
+		return [&]<std::size_t... Is>(std::index_sequence<Is...>)
+		{
+			return record<N, F>{make_field<F>(seed + Is)...};
+		}(std::make_index_sequence<N>{});
+	}
+};
+
+template <typename T>
+using aos = std::vector<T>;
+
+template <typename T>
+using soa_vectors = soa::struct_array<T>;
+
+template <typename T>
+using soa_block = soa::struct_array<T, soa::layout::block<>>;
+
+// the first three fields share one interleaved column, e.g. a position read together
+template <typename T>
+using soa_grouped = soa::struct_array<T, soa::layout::grouped<soa::group<0, 1, 2>>>;
+
+// field I of row i, the same code path for both representations
+template <std::size_t I, typename T>
+[[nodiscard]]
+auto field(const std::vector<T> &c, const std::size_t i) noexcept -> decltype(auto)
+{
+	return std::get<I>(soa::make_tie<T>(c[i]));
+}
+
+template <std::size_t I, typename T, typename Is, typename S>
+[[nodiscard]]
+auto field(const soa::impl::struct_array_impl<T, Is, S> &c, const std::size_t i) noexcept -> decltype(auto)
+{
+	return std::get<I>(c[i]);
+}
+
+template <typename T, typename... Fs>
+void emplace_row(std::vector<T> &c, Fs &&...fields)
+{
+	c.emplace_back(std::forward<Fs>(fields)...);
+}
+
+template <typename T, typename Is, typename S, typename... Fs>
+void emplace_row(soa::impl::struct_array_impl<T, Is, S> &c, Fs &&...fields)
+{
+	c.emplace_back(std::forward_as_tuple(std::forward<Fs>(fields))...);
+}
+
+template <typename T>
+[[nodiscard]]
+auto sum_fields(const std::vector<T> &c) noexcept -> std::uint64_t
+{
+	std::uint64_t sum = 0U;
+	for (const auto &row : c)
+		std::apply([&](const auto &...fields) { sum += (... + key(fields)); }, soa::make_tie<T>(row));
+	return sum;
+}
+
+template <typename T, typename Is, typename S>
+[[nodiscard]]
+auto sum_fields(const soa::impl::struct_array_impl<T, Is, S> &c) noexcept -> std::uint64_t
+{
+	std::uint64_t sum = 0U;
+	for (const auto &row : c)
+		[&]<std::size_t... Js>(std::index_sequence<Js...>)
+		{
+			sum += (... + key(soa::get<Js>(row)));
+		}(Is{});
+	return sum;
+}
+
+template <typename T>
+[[nodiscard]]
+auto sum_first(const std::vector<T> &c) noexcept -> std::uint64_t
+{
+	std::uint64_t sum = 0U;
+	for (const auto &row : c)
+		sum += key(std::get<0>(soa::make_tie<T>(row)));
+	return sum;
+}
+
+template <typename T, typename Is, typename S>
+[[nodiscard]]
+auto sum_first(const soa::impl::struct_array_impl<T, Is, S> &c) noexcept -> std::uint64_t
+{
+	std::uint64_t sum = 0U;
+	for (const auto &[x] : c.template project<0>())
+		sum += key(x);
+	return sum;
+}
+
+template <typename T>
+[[nodiscard]]
+auto sum_group(const std::vector<T> &c, const std::vector<std::size_t> &indices) noexcept -> std::uint64_t
+{
+	std::uint64_t sum = 0U;
+	for (const auto i : indices)
+	{
+		const auto fields = soa::make_tie<T>(c[i]);
+		sum += key(std::get<0>(fields)) + key(std::get<1>(fields)) + key(std::get<2>(fields));
+	}
+	return sum;
+}
+
+template <typename T, typename Is, typename S>
+[[nodiscard]]
+auto sum_group(const soa::impl::struct_array_impl<T, Is, S> &c, const std::vector<std::size_t> &indices) noexcept
+	-> std::uint64_t
+{
+	const auto group = c.template project<0, 1, 2>();
+	std::uint64_t sum = 0U;
+	for (const auto i : indices)
+	{
+		const auto &[x, y, z] = group[i];
+		sum += key(x) + key(y) + key(z);
+	}
+	return sum;
+}
+
+template <typename T>
+void sort_first(std::vector<T> &c)
+{
+	std::sort(std::begin(c), std::end(c), [](const T &l, const T &r)
+	{
+		return key(std::get<0>(soa::make_tie<T>(l))) < key(std::get<0>(soa::make_tie<T>(r)));
+	});
+}
+
+template <typename T, typename Is, typename S>
+void sort_first(soa::impl::struct_array_impl<T, Is, S> &c)
+{
+	std::sort(std::begin(c), std::end(c), [](const auto &l, const auto &r)
+	{
+		return key(soa::get<0>(l)) < key(soa::get<0>(r));
+	});
+}
+
+template <template <typename> class C, typename T>
+[[nodiscard]]
+auto make_container(const std::size_t n) -> C<T>
+{
+	std::mt19937_64 random{n};
+	C<T> c;
+	c.reserve(n);
+	for (std::size_t i = 0U; i < n; ++i)
+		c.push_back(record_traits<T>::make(random()));
+	return c;
+}
+
+// allocations per iteration, counted from here until the end of the scope
+class allocation_counter
+{
+public:
+	explicit allocation_counter(benchmark::State &state) noexcept
+		: state{state}, first{allocations.load(std::memory_order_relaxed)}
+	{
+	}
+
+	allocation_counter(const allocation_counter &) = delete;
+
+	~allocation_counter()
+	{
+		state.counters["allocs"] = benchmark::Counter(
+			static_cast<double>(allocations.load(std::memory_order_relaxed) - first), benchmark::Counter::kAvgIterations);
+	}
+
+	auto operator=(const allocation_counter &) -> allocation_counter& = delete;
+
+private:
+	benchmark::State &state;
+	std::size_t first;
+};
+
+template <template <typename> class C, typename T>
+void push_back(benchmark::State &state)
+{
+	const auto n = static_cast<std::size_t>(state.range(0));
+	allocation_counter counter{state};
+	for (auto _ : state)
+	{
+		C<T> c;
+		for (std::size_t i = 0U; i < n; ++i)
+			c.push_back(record_traits<T>::make(i));
+		benchmark::DoNotOptimize(c);
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+template <template <typename> class C, typename T>
+void emplace_back(benchmark::State &state)
+{
+	using F = typename record_traits<T>::field_type;
+	const auto n = static_cast<std::size_t>(state.range(0));
+	allocation_counter counter{state};
+	for (auto _ : state)
+	{
+		C<T> c;
+		for (std::size_t i = 0U; i < n; ++i)
+			[&]<std::size_t... Is>(std::index_sequence<Is...>)
+			{
+				emplace_row(c, make_field<F>(i + Is)...);
+			}(std::make_index_sequence<record_traits<T>::fields>{});
+		benchmark::DoNotOptimize(c);
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+template <template <typename> class C, typename T>
+void iterate(benchmark::State &state)
+{
+	const auto c = make_container<C, T>(static_cast<std::size_t>(state.range(0)));
+	allocation_counter counter{state};
+	for (auto _ : state)
+		benchmark::DoNotOptimize(sum_fields(c));
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(T)));
+}
+
+template <template <typename> class C, typename T>
+void iterate_projected(benchmark::State &state)
+{
+	using F = typename record_traits<T>::field_type;
+	const auto c = make_container<C, T>(static_cast<std::size_t>(state.range(0)));
+	allocation_counter counter{state};
+	for (auto _ : state)
+		benchmark::DoNotOptimize(sum_first(c));
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(sizeof(F)));
+}
+
+template <template <typename> class C, typename T>
+void random_access(benchmark::State &state)
+{
+	constexpr std::size_t lookups = 4096U;
+
+	const auto n = static_cast<std::size_t>(state.range(0));
+	const auto c = make_container<C, T>(n);
+	std::mt19937_64 random{n};
+	std::vector<std::size_t> indices(lookups);
+	std::generate(std::begin(indices), std::end(indices), [&] { return static_cast<std::size_t>(random() % n); });
+
+	allocation_counter counter{state};
+	for (auto _ : state)
+	{
+		std::uint64_t sum = 0U;
+		for (const auto i : indices)
+			sum += key(field<0>(c, i));
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(lookups));
+}
+
+// reads the first three fields of random rows, the access pattern soa_grouped interleaves for
+template <template <typename> class C, typename T>
+void random_group(benchmark::State &state)
+{
+	constexpr std::size_t lookups = 4096U;
+
+	const auto n = static_cast<std::size_t>(state.range(0));
+	const auto c = make_container<C, T>(n);
+	std::mt19937_64 random{n};
+	std::vector<std::size_t> indices(lookups);
+	std::generate(std::begin(indices), std::end(indices), [&] { return static_cast<std::size_t>(random() % n); });
+
+	allocation_counter counter{state};
+	for (auto _ : state)
+		benchmark::DoNotOptimize(sum_group(c, indices));
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(lookups));
+}
+
+template <template <typename> class C, typename T>
+void sort(benchmark::State &state)
+{
+	const auto source = make_container<C, T>(static_cast<std::size_t>(state.range(0)));
+	auto c = source;
+	allocation_counter counter{state};
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		c = source;
+		state.ResumeTiming();
+		sort_first(c);
+		benchmark::DoNotOptimize(c);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <template <typename> class C, typename T>
+void insert_erase_middle(benchmark::State &state)
+{
+	const auto n = static_cast<std::size_t>(state.range(0));
+	auto c = make_container<C, T>(n);
+	c.reserve(n + 1U);
+	const auto row = record_traits<T>::make(n);
+	allocation_counter counter{state};
+	for (auto _ : state)
+	{
+		c.insert(std::cbegin(c) + static_cast<std::ptrdiff_t>(n / 2U), row);
+		c.erase(std::cbegin(c) + static_cast<std::ptrdiff_t>(n / 2U));
+		benchmark::DoNotOptimize(c);
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+template <template <typename> class C, typename T>
+void reserve_resize(benchmark::State &state)
+{
+	const auto n = static_cast<std::size_t>(state.range(0));
+	const auto first = allocated_bytes.load(std::memory_order_relaxed);
+	allocation_counter counter{state};
+	for (auto _ : state)
+	{
+		C<T> c;
+		c.reserve(n);
+		c.resize(n);
+		benchmark::DoNotOptimize(c);
+	}
+	state.counters["bytes_per_element"] = static_cast<double>(allocated_bytes.load(std::memory_order_relaxed) - first)
+		/ static_cast<double>(state.iterations() * n);
+	state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(n));
+}
+
+// element counts for footprints of 16 KiB (L1), 512 KiB (L2), 16 MiB (LLC) and 256 MiB
+template <typename T>
+void footprints(benchmark::internal::Benchmark *benchmark)
+{
+	for (const std::size_t bytes : {std::size_t{16U} << 10U, std::size_t{512U} << 10U, std::size_t{16U} << 20U,
+	                                std::size_t{256U} << 20U})
+		benchmark->Arg(static_cast<std::int64_t>(bytes / sizeof(T)));
+}
+
+template <template <typename> class C, typename T>
+void register_container(const std::string &container)
+{
+	const auto prefix = container + '/' + std::to_string(record_traits<T>::fields) + 'x'
+		+ std::to_string(sizeof(typename record_traits<T>::field_type)) + "B/";
+
+	benchmark::RegisterBenchmark((prefix + "push_back").c_str(), push_back<C, T>)->Apply(footprints<T>);
+	benchmark::RegisterBenchmark((prefix + "emplace_back").c_str(), emplace_back<C, T>)->Apply(footprints<T>);
+	benchmark::RegisterBenchmark((prefix + "iterate").c_str(), iterate<C, T>)->Apply(footprints<T>);
+	benchmark::RegisterBenchmark((prefix + "iterate_projected").c_str(), iterate_projected<C, T>)->Apply(footprints<T>);
+	benchmark::RegisterBenchmark((prefix + "random_access").c_str(), random_access<C, T>)->Apply(footprints<T>);
+	if constexpr (record_traits<T>::fields >= 3U)
+		benchmark::RegisterBenchmark((prefix + "random_group").c_str(), random_group<C, T>)->Apply(footprints<T>);
+	benchmark::RegisterBenchmark((prefix + "sort").c_str(), sort<C, T>)->Apply(footprints<T>);
+	benchmark::RegisterBenchmark((prefix + "insert_erase_middle").c_str(), insert_erase_middle<C, T>)
+		->Apply(footprints<T>);
+	benchmark::RegisterBenchmark((prefix + "reserve_resize").c_str(), reserve_resize<C, T>)->Apply(footprints<T>);
+}
+
+template <typename T>
+void register_layouts()
+{
+	register_container<aos, T>("aos");
+	register_container<soa_vectors, T>("soa_vectors");
+	register_container<soa_block, T>("soa_block");
+	if constexpr (record_traits<T>::fields >= 3U)
+		register_container<soa_grouped, T>("soa_grouped");
+}
+
+template <typename F, std::size_t... Ns>
+void register_records(std::index_sequence<Ns...>)
+{
+	(..., register_layouts<record<Ns + 1U, F>>());
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+	constexpr auto field_counts = std::make_index_sequence<std::min(SOA_MAX_BINDINGS - 1, 4)>{};
+	register_records<std::uint32_t>(field_counts);
+	register_records<wide>(field_counts);
+	register_layouts<record32>();
+
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv))
+		return 1;
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
@@ -0,0 +1,113 @@
+#ifndef SOA_AOS_H
+#define SOA_AOS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "struct_array.h"
+#include "to_tuple.h"
+
+// Conversion back to arrays of structures for anything with project() and struct_type, i.e.
+// struct_array (all layouts) and struct_array_view. Contiguous outputs are filled column by
+// column in blocks of about transpose_block_bytes, so every column is read sequentially while
+// the block of T being written stays in cache; other output iterators get one T per row.
+namespace soa
+{
+namespace impl
+{
+template <typename A>
+using struct_type_t = typename std::remove_cvref_t<A>::struct_type;
+
+template <typename A>
+using struct_indices_t = std::make_index_sequence<std::tuple_size_v<to_tuple_t<struct_type_t<A>>>>;
+
+template <typename T>
+inline static constexpr std::size_t aos_block_rows = std::max(std::size_t{1U}, transpose_block_bytes / sizeof(T));
+
+// rows [first, last) of array into the objects out[0, last - first)
+template <typename A, std::size_t... Is>
+void to_aos(const A &array, std::size_t first, const std::size_t last, struct_type_t<A> *out,
+            std::index_sequence<Is...>)
+{
+	using T = struct_type_t<A>;
+	const auto columns = array.template project<Is...>().first;
+
+	for (; first < last; first += aos_block_rows<T>, out += aos_block_rows<T>)
+	{
+		const auto rows = std::min(last - first, aos_block_rows<T>);
+		(..., [&]
+		{
+			const auto column = std::get<Is>(columns) + static_cast<std::ptrdiff_t>(first);
+			for (std::size_t i = 0U; i < rows; ++i)
+				std::get<Is>(make_tie<T>(out[i])) = column[static_cast<std::ptrdiff_t>(i)];
+		}());
+	}
+}
+
+// out[k] = row indices[k] for k in [0, n)
+template <typename A, typename It, std::size_t... Is>
+void gather(const A &array, It indices, std::size_t n, struct_type_t<A> *out, std::index_sequence<Is...>)
+{
+	using T = struct_type_t<A>;
+	const auto columns = array.template project<Is...>().first;
+
+	for (; n > 0U; n -= std::min(n, aos_block_rows<T>))
+	{
+		const auto rows = std::min(n, aos_block_rows<T>);
+		(..., [&]
+		{
+			const auto column = std::get<Is>(columns);
+			for (std::size_t i = 0U; i < rows; ++i)
+				std::get<Is>(make_tie<T>(out[i])) = column[static_cast<std::ptrdiff_t>(indices[i])];
+		}());
+		indices += static_cast<std::iter_difference_t<It>>(rows);
+		out += rows;
+	}
+}
+} // namespace impl
+
+// writes every row as a T to out, out points to size() objects if it is a T *
+template <typename A, std::output_iterator<impl::struct_type_t<A>> OutputIt>
+auto to_aos(const A &array, OutputIt out) -> OutputIt
+{
+	using T = impl::struct_type_t<A>;
+	const auto n = std::size(array);
+
+	if constexpr (std::is_same_v<OutputIt, T *>)
+	{
+		impl::to_aos(array, 0U, n, out, impl::struct_indices_t<A>{});
+		return out + n;
+	}
+	else
+	{
+		for (std::size_t i = 0U; i < n; ++i, ++out)
+			*out = soa::make_from_tuple<T>(array[i]);
+		return out;
+	}
+}
+
+template <typename A>
+[[nodiscard]]
+auto to_aos(const A &array) -> std::vector<impl::struct_type_t<A>>
+{
+	std::vector<impl::struct_type_t<A>> result(std::size(array));
+	to_aos(array, std::data(result));
+	return result;
+}
+
+// out[k] = row indices[k] for every k, out points to std::size(indices) objects
+template <typename A, std::ranges::random_access_range Indices>
+requires std::integral<std::ranges::range_value_t<Indices>>
+void gather(const A &array, const Indices &indices, impl::struct_type_t<A> *const out)
+{
+	impl::gather(array, std::ranges::begin(indices), std::ranges::size(indices), out, impl::struct_indices_t<A>{});
+}
+} // namespace soa
+
+#endif // SOA_AOS_H
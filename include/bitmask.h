@@ -0,0 +1,172 @@
+#ifndef SOA_BITMASK_H
+#define SOA_BITMASK_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace soa
+{
+// one bit per row of a struct_array, bit i of word i / 64 selects row i
+class bitmask
+{
+public:
+	using word_type = std::uint64_t;
+	using size_type = std::size_t;
+
+	static constexpr size_type word_bits = 64U;
+
+	bitmask() = default;
+
+	explicit bitmask(const size_type count, const bool value = false)
+		: bits((count + word_bits - 1U) / word_bits, value ? ~word_type{0U} : word_type{0U}),
+		  size_bits{count}
+	{
+		clear_padding();
+	}
+
+	[[nodiscard]]
+	auto size() const noexcept -> size_type
+	{
+		return size_bits;
+	}
+
+	[[nodiscard]]
+	bool empty() const noexcept
+	{
+		return size_bits == 0U;
+	}
+
+	[[nodiscard]]
+	bool test(const size_type pos) const noexcept
+	{
+		return (bits[pos / word_bits] >> (pos % word_bits)) & 1U;
+	}
+
+	[[nodiscard]]
+	bool operator[](const size_type pos) const noexcept
+	{
+		return test(pos);
+	}
+
+	void set(const size_type pos, const bool value = true) noexcept
+	{
+		const auto bit = word_type{1U} << (pos % word_bits);
+		if (value)
+			bits[pos / word_bits] |= bit;
+		else
+			bits[pos / word_bits] &= ~bit;
+	}
+
+	void reset(const size_type pos) noexcept
+	{
+		set(pos, false);
+	}
+
+	// sets bits [first, last), whole words at a time
+	void set_range(size_type first, const size_type last) noexcept
+	{
+		for (; first < last && first % word_bits != 0U; ++first)
+			set(first);
+		for (; first + word_bits <= last; first += word_bits)
+			bits[first / word_bits] = ~word_type{0U};
+		for (; first < last; ++first)
+			set(first);
+	}
+
+	// number of set bits
+	[[nodiscard]]
+	auto count() const noexcept -> size_type
+	{
+		return std::accumulate(std::begin(bits), std::end(bits), size_type{0U},
+		                       [](const size_type n, const word_type w) noexcept
+		                       {
+			                       return n + static_cast<size_type>(std::popcount(w));
+		                       });
+	}
+
+	[[nodiscard]]
+	bool any() const noexcept
+	{
+		return std::any_of(std::begin(bits), std::end(bits), [](const word_type w) noexcept { return w != 0U; });
+	}
+
+	[[nodiscard]]
+	bool none() const noexcept
+	{
+		return !any();
+	}
+
+	[[nodiscard]]
+	auto words() noexcept -> std::span<word_type>
+	{
+		return bits;
+	}
+
+	[[nodiscard]]
+	auto words() const noexcept -> std::span<const word_type>
+	{
+		return bits;
+	}
+
+	auto flip() noexcept -> bitmask&
+	{
+		for (auto &w : bits)
+			w = ~w;
+		clear_padding();
+		return *this;
+	}
+
+	auto operator&=(const bitmask &that) noexcept -> bitmask&
+	{
+		std::transform(std::begin(bits), std::end(bits), std::begin(that.bits), std::begin(bits),
+		               [](const word_type l, const word_type r) noexcept { return l & r; });
+		return *this;
+	}
+
+	auto operator|=(const bitmask &that) noexcept -> bitmask&
+	{
+		std::transform(std::begin(bits), std::end(bits), std::begin(that.bits), std::begin(bits),
+		               [](const word_type l, const word_type r) noexcept { return l | r; });
+		return *this;
+	}
+
+	[[nodiscard]]
+	auto operator~() const -> bitmask
+	{
+		return bitmask{*this}.flip();
+	}
+
+	[[nodiscard]]
+	friend auto operator&(bitmask lhs, const bitmask &rhs) -> bitmask
+	{
+		return lhs &= rhs;
+	}
+
+	[[nodiscard]]
+	friend auto operator|(bitmask lhs, const bitmask &rhs) -> bitmask
+	{
+		return lhs |= rhs;
+	}
+
+	[[nodiscard]]
+	friend bool operator==(const bitmask &, const bitmask &) = default;
+
+private:
+	std::vector<word_type> bits;
+	size_type size_bits = 0U;
+
+	// bits past size() are kept zero so count() and operator== can work on whole words
+	void clear_padding() noexcept
+	{
+		if (const auto tail = size_bits % word_bits; tail != 0U)
+			bits.back() &= (word_type{1U} << tail) - 1U;
+	}
+};
+} // namespace soa
+
+#endif // SOA_BITMASK_H
@@ -0,0 +1,35 @@
+#ifndef SOA_CHUNKED_STRUCT_ARRAY_H
+#define SOA_CHUNKED_STRUCT_ARRAY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "layout.h"
+#include "struct_array.h"
+#include "struct_array_view.h"
+
+namespace soa
+{
+// struct_array that grows by adding chunks of ChunkSize rows, existing rows are never relocated
+template <typename T, std::size_t ChunkSize = 4096U, typename Allocator = std::allocator<std::byte>>
+using chunked_struct_array = struct_array<T, layout::chunked<ChunkSize>, Allocator>;
+
+// calls f with a struct_array_view over the rows of every chunk in order, so the contiguous
+// kernels (simd, compact, aos) can run chunk by chunk; a const array gives views of const T
+template <typename A, typename F>
+requires requires { std::remove_cvref_t<A>::storage_type::chunk_size; }
+void for_each_segment(A &array, F &&f)
+{
+	using T = std::conditional_t<std::is_const_v<A>, const typename A::struct_type, typename A::struct_type>;
+	constexpr auto chunk_size = A::storage_type::chunk_size;
+
+	const auto n = std::size(array);
+	for (std::size_t k = 0U; k * chunk_size < n; ++k)
+		f(struct_array_view<T>{array.components.chunk_data(k), std::min(chunk_size, n - k * chunk_size)});
+}
+} // namespace soa
+
+#endif // SOA_CHUNKED_STRUCT_ARRAY_H
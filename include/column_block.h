@@ -0,0 +1,487 @@
+#ifndef SOA_COLUMN_BLOCK_H
+#define SOA_COLUMN_BLOCK_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <ranges>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace soa
+{
+namespace impl
+{
+// columns stored one after another, each one starting on an Alignment boundary
+template <std::size_t Alignment, typename... Ts>
+struct contiguous_addressing
+{
+	using iterator = std::tuple<Ts *...>;
+	using const_iterator = std::tuple<const Ts *...>;
+
+	static constexpr std::size_t alignment = std::max({Alignment, alignof(Ts)...});
+
+	static_assert((alignment & (alignment - 1U)) == 0U, "alignment has to be a power of two");
+
+	[[nodiscard]]
+	static constexpr auto capacity_for(const std::size_t count) noexcept -> std::size_t
+	{
+		return count;
+	}
+
+	[[nodiscard]]
+	static constexpr auto bytes_for(const std::size_t capacity) noexcept -> std::size_t
+	{
+		return (std::size_t{0U} + ... + round_up(capacity * sizeof(Ts)));
+	}
+
+	[[nodiscard]]
+	static auto carve(std::byte *const block, const std::size_t capacity) noexcept -> iterator
+	{
+		iterator result{};
+		std::size_t offset = 0U;
+		[&]<std::size_t... Is>(std::index_sequence<Is...>)
+		{
+			(..., (std::get<Is>(result) = reinterpret_cast<Ts *>(block + offset),
+				offset += round_up(capacity * sizeof(Ts))));
+		}(std::index_sequence_for<Ts...>{});
+		return result;
+	}
+
+private:
+	[[nodiscard]]
+	static constexpr auto round_up(const std::size_t bytes) noexcept -> std::size_t
+	{
+		return (bytes + alignment - 1U) & ~(alignment - 1U);
+	}
+};
+
+// unit the allocator hands out, so over-aligned blocks come from any allocator honouring alignof
+template <std::size_t Alignment>
+struct alignas(Alignment) aligned_chunk
+{
+	std::byte bytes[Alignment];
+};
+
+template <typename Addressing, typename T, typename, typename Allocator>
+class column_block;
+
+// every column lives in one allocation whose arrangement is given by Addressing, all columns
+// share a single size and capacity
+template <typename Addressing, typename... Ts, std::size_t... Is, typename Allocator>
+class column_block<Addressing, std::tuple<Ts...>, std::index_sequence<Is...>, Allocator>
+{
+	using chunk = aligned_chunk<Addressing::alignment>;
+	using chunk_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<chunk>;
+	using chunk_traits = std::allocator_traits<chunk_allocator>;
+
+public:
+	using value_type = std::tuple<Ts...>;
+	using allocator_type = Allocator;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = std::tuple<Ts &...>;
+	using const_reference = std::tuple<const Ts &...>;
+	using pointer = std::tuple<Ts *...>;
+	using const_pointer = std::tuple<const Ts *...>;
+	using iterator = typename Addressing::iterator;
+	using const_iterator = typename Addressing::const_iterator;
+	using reverse_iterator = std::tuple<std::reverse_iterator<std::tuple_element_t<Is, iterator>>...>;
+	using const_reverse_iterator = std::tuple<std::reverse_iterator<std::tuple_element_t<Is, const_iterator>>...>;
+
+	static constexpr std::size_t alignment = Addressing::alignment;
+
+	column_block() noexcept(noexcept(chunk_allocator())) = default;
+
+	explicit column_block(const Allocator &alloc) noexcept
+		: allocator{alloc}
+	{
+	}
+
+	column_block(const column_block &that)
+		: column_block{that, allocator_type(chunk_traits::select_on_container_copy_construction(that.allocator))}
+	{
+	}
+
+	// delegates first, so the destructor frees the block if a copy throws
+	column_block(const column_block &that, const Allocator &alloc)
+		: column_block{alloc}
+	{
+		reserve(that.count);
+		construct_columns(columns, 0U, that.count, [&](auto i, auto p, const size_type n)
+		{
+			std::uninitialized_copy_n(std::get<decltype(i)::value>(that.columns), n, p);
+		});
+		count = that.count;
+	}
+
+	column_block(column_block &&that) noexcept
+		: allocator{std::move(that.allocator)},
+		  buffer{std::exchange(that.buffer, nullptr)},
+		  columns{std::exchange(that.columns, iterator{})},
+		  count{std::exchange(that.count, 0U)},
+		  cap{std::exchange(that.cap, 0U)}
+	{
+	}
+
+	// takes over the block if alloc can free it, otherwise moves the rows element-wise
+	column_block(column_block &&that, const Allocator &alloc)
+		: column_block{alloc}
+	{
+		if (allocator == that.allocator)
+		{
+			swap_block(that);
+			return;
+		}
+
+		reserve(that.count);
+		construct_columns(columns, 0U, that.count, [&](auto i, auto p, const size_type n)
+		{
+			std::uninitialized_move_n(std::get<decltype(i)::value>(that.columns), n, p);
+		});
+		count = that.count;
+	}
+
+	~column_block()
+	{
+		clear();
+		deallocate(buffer, cap);
+	}
+
+	auto operator=(const column_block &that) -> column_block&
+	{
+		if (this != &that)
+		{
+			column_block copy{that, propagate_on_copy ? that.get_allocator() : get_allocator()};
+			swap_block(copy);
+			if constexpr (propagate_on_copy)
+				std::swap(allocator, copy.allocator);
+		}
+		return *this;
+	}
+
+	auto operator=(column_block &&that) noexcept(propagate_on_move || chunk_traits::is_always_equal::value)
+		-> column_block&
+	{
+		column_block moved{std::move(that), propagate_on_move ? that.get_allocator() : get_allocator()};
+		swap_block(moved);
+		if constexpr (propagate_on_move)
+			std::swap(allocator, moved.allocator);
+		return *this;
+	}
+
+	[[nodiscard]]
+	auto get_allocator() const noexcept -> allocator_type
+	{
+		return allocator_type(allocator);
+	}
+
+	template <std::size_t I>
+	[[nodiscard]]
+	auto column() noexcept -> std::ranges::subrange<std::tuple_element_t<I, iterator>>
+	{
+		return {std::get<I>(columns), std::get<I>(columns) + count};
+	}
+
+	template <std::size_t I>
+	[[nodiscard]]
+	auto column() const noexcept -> std::ranges::subrange<std::tuple_element_t<I, const_iterator>>
+	{
+		return {std::get<I>(columns), std::get<I>(columns) + count};
+	}
+
+	[[nodiscard]]
+	bool empty() const noexcept
+	{
+		return count == 0U;
+	}
+
+	[[nodiscard]]
+	auto size() const noexcept -> size_type
+	{
+		return count;
+	}
+
+	[[nodiscard]]
+	static constexpr auto max_size() noexcept -> size_type
+	{
+		return static_cast<size_type>(std::numeric_limits<difference_type>::max()) / (alignment + ... + sizeof(Ts));
+	}
+
+	[[nodiscard]]
+	auto capacity() const noexcept -> size_type
+	{
+		return cap;
+	}
+
+	void reserve(const size_type new_cap)
+	{
+		if (new_cap > cap)
+			reallocate(new_cap, 0U, [](auto, auto, size_type) noexcept {});
+	}
+
+	void shrink_to_fit()
+	{
+		if (count == 0U)
+		{
+			deallocate(std::exchange(buffer, nullptr), std::exchange(cap, 0U));
+			columns = iterator{};
+		}
+		else if (cap > count)
+			reallocate(count, 0U, [](auto, auto, size_type) noexcept {});
+	}
+
+	void clear() noexcept
+	{
+		(..., std::destroy_n(std::get<Is>(columns), count));
+		count = 0U;
+	}
+
+	template <typename U>
+	void insert(const size_type pos, U &&value)
+	{
+		push_back(std::forward<U>(value));
+		rotate_back(pos, 1U);
+	}
+
+	void insert(const size_type pos, const size_type n, const value_type &value)
+	{
+		if (n == 0U)
+			return;
+
+		if (count + n > cap)
+			reserve(grow_capacity(count + n));
+		construct_columns(columns, count, n, [&](auto i, auto p, const size_type k)
+		{
+			std::uninitialized_fill_n(p, k, std::get<decltype(i)::value>(value));
+		});
+		count += n;
+		rotate_back(pos, n);
+	}
+
+	template <typename...Args>
+	void emplace(const size_type pos, Args &&...args)
+	{
+		emplace_back(std::forward<Args>(args)...);
+		rotate_back(pos, 1U);
+	}
+
+	void erase(const size_type first, const size_type last)
+	{
+		if (first == last)
+			return;
+
+		const auto n = last - first;
+		(..., std::move(std::get<Is>(columns) + last, std::get<Is>(columns) + count, std::get<Is>(columns) + first));
+		(..., std::destroy_n(std::get<Is>(columns) + count - n, n));
+		count -= n;
+	}
+
+	void push_back(const value_type &value)
+	{
+		emplace_back(std::forward_as_tuple(std::get<Is>(value))...);
+	}
+
+	void push_back(value_type &&value)
+	{
+		emplace_back(std::forward_as_tuple(std::move(std::get<Is>(value)))...);
+	}
+
+	template <typename...Args>
+	requires (sizeof...(Args) == sizeof...(Ts))
+	auto emplace_back(Args &&...args) -> reference
+	{
+		auto row = std::forward_as_tuple(std::forward<Args>(args)...);
+		const auto construct = [&](auto i, auto p, size_type)
+		{
+			std::apply([&](auto &&...xs)
+			{
+				std::construct_at(std::addressof(*p), std::forward<decltype(xs)>(xs)...);
+			}, std::get<decltype(i)::value>(std::move(row)));
+		};
+
+		// arguments may refer to our own elements, so build the new row before relocating
+		if (count == cap)
+			reallocate(grow_capacity(count + 1U), 1U, construct);
+		else
+			construct_columns(columns, count, 1U, construct);
+
+		++count;
+		return {std::get<Is>(columns)[count - 1U]...};
+	}
+
+	// appends n rows, column I copied from firsts[I], which must not point into this block
+	template <typename... Its>
+	void append(const size_type n, Its... firsts)
+	{
+		if (count + n > cap)
+			reserve(grow_capacity(count + n));
+
+		const std::tuple<Its...> sources{firsts...};
+		construct_columns(columns, count, n, [&](auto i, auto p, const size_type k)
+		{
+			std::uninitialized_copy_n(std::get<decltype(i)::value>(sources), k, p);
+		});
+		count += n;
+	}
+
+	void pop_back()
+	{
+		--count;
+		(..., std::destroy_at(std::addressof(*(std::get<Is>(columns) + count))));
+	}
+
+	void resize(const size_type n)
+	{
+		if (n <= count)
+		{
+			erase(n, count);
+			return;
+		}
+
+		reserve(n);
+		construct_columns(columns, count, n - count, [](auto, auto p, const size_type k)
+		{
+			std::uninitialized_value_construct_n(p, k);
+		});
+		count = n;
+	}
+
+	void resize(const size_type n, const value_type &value)
+	{
+		if (n <= count)
+			erase(n, count);
+		else
+			insert(count, n - count, value);
+	}
+
+	// like the standard containers, allocators that do not propagate on swap have to compare equal
+	void swap(column_block &other) noexcept
+	{
+		if constexpr (chunk_traits::propagate_on_container_swap::value)
+			std::swap(allocator, other.allocator);
+		swap_block(other);
+	}
+
+private:
+	static constexpr bool propagate_on_copy = chunk_traits::propagate_on_container_copy_assignment::value;
+	static constexpr bool propagate_on_move = chunk_traits::propagate_on_container_move_assignment::value;
+
+	[[no_unique_address]] chunk_allocator allocator{};
+	std::byte *buffer = nullptr;
+	iterator columns{};
+	size_type count = 0U;
+	size_type cap = 0U;
+
+	[[nodiscard]]
+	static constexpr auto chunks_for(const size_type capacity) noexcept -> size_type
+	{
+		return (Addressing::bytes_for(capacity) + sizeof(chunk) - 1U) / sizeof(chunk);
+	}
+
+	[[nodiscard]]
+	auto allocate(const size_type capacity) -> std::byte*
+	{
+		if (capacity > max_size())
+			throw std::length_error{"soa::column_block: capacity exceeds max_size()"};
+
+		return reinterpret_cast<std::byte *>(std::to_address(chunk_traits::allocate(allocator, chunks_for(capacity))));
+	}
+
+	void deallocate(std::byte *const block, const size_type capacity) noexcept
+	{
+		if (block != nullptr)
+			chunk_traits::deallocate(allocator, reinterpret_cast<chunk *>(block), chunks_for(capacity));
+	}
+
+	// exchanges everything but the allocators
+	void swap_block(column_block &other) noexcept
+	{
+		std::swap(buffer, other.buffer);
+		std::swap(columns, other.columns);
+		std::swap(count, other.count);
+		std::swap(cap, other.cap);
+	}
+
+	[[nodiscard]]
+	auto grow_capacity(const size_type required) const noexcept -> size_type
+	{
+		return std::max(required, 2U * cap);
+	}
+
+	// constructs rows [first, first + n) column by column, destroying finished columns on failure
+	template <typename F>
+	static void construct_columns(const iterator &target, const size_type first, const size_type n, F &&construct)
+	{
+		size_type done = 0U;
+		try
+		{
+			(..., (construct(std::integral_constant<std::size_t, Is>{}, std::get<Is>(target) + first, n), ++done));
+		}
+		catch (...)
+		{
+			(..., (Is < done ? static_cast<void>(std::destroy_n(std::get<Is>(target) + first, n)) : void()));
+			throw;
+		}
+	}
+
+	// one allocation and one relocation pass, rows [count, count + extra) are built by construct first
+	template <typename F>
+	void reallocate(const size_type capacity, const size_type extra, F &&construct)
+	{
+		const auto new_cap = Addressing::capacity_for(capacity);
+		auto *const new_buffer = allocate(new_cap);
+		const auto new_columns = Addressing::carve(new_buffer, new_cap);
+
+		try
+		{
+			construct_columns(new_columns, count, extra, construct);
+		}
+		catch (...)
+		{
+			deallocate(new_buffer, new_cap);
+			throw;
+		}
+
+		try
+		{
+			construct_columns(new_columns, 0U, count, [&](auto i, auto p, const size_type n)
+			{
+				using U = std::iter_value_t<decltype(p)>;
+				if constexpr (std::is_nothrow_move_constructible_v<U> || !std::is_copy_constructible_v<U>)
+					std::uninitialized_move_n(std::get<decltype(i)::value>(columns), n, p);
+				else
+					std::uninitialized_copy_n(std::get<decltype(i)::value>(columns), n, p);
+			});
+		}
+		catch (...)
+		{
+			(..., std::destroy_n(std::get<Is>(new_columns) + count, extra));
+			deallocate(new_buffer, new_cap);
+			throw;
+		}
+
+		(..., std::destroy_n(std::get<Is>(columns), count));
+		deallocate(buffer, cap);
+
+		buffer = new_buffer;
+		columns = new_columns;
+		cap = new_cap;
+	}
+
+	// moves the trailing n rows in front of pos
+	void rotate_back(const size_type pos, const size_type n)
+	{
+		(..., std::rotate(std::get<Is>(columns) + pos, std::get<Is>(columns) + count - n,
+		                  std::get<Is>(columns) + count));
+	}
+};
+} // namespace impl
+} // namespace soa
+
+#endif // SOA_COLUMN_BLOCK_H
@@ -0,0 +1,568 @@
+#ifndef SOA_COLUMN_CHUNKS_H
+#define SOA_COLUMN_CHUNKS_H
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "column_block.h"
+
+namespace soa
+{
+namespace impl
+{
+// iterator over one field of a chunked storage: element i lives in chunk i / ChunkSize at row
+// i % ChunkSize, the field starts Offset bytes into every chunk. It refers to the chunk directory
+// itself, so it stays valid when the directory grows but not once the storage is moved, move
+// assigned or swapped, which hands the directory to another storage object
+template <typename T, std::size_t ChunkSize, std::size_t Offset, typename Directory>
+class chunk_iterator
+{
+	using byte_type = std::conditional_t<std::is_const_v<T>, const std::byte, std::byte>;
+
+public:
+	using iterator_concept = std::random_access_iterator_tag;
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = std::remove_cv_t<T>;
+	using difference_type = std::ptrdiff_t;
+	using reference = T&;
+	using pointer = T*;
+
+	chunk_iterator() noexcept = default;
+
+	chunk_iterator(const Directory *const directory, const difference_type index) noexcept
+		: directory{directory}, index{index}
+	{
+	}
+
+	// conversion to const iterator
+	operator chunk_iterator<const T, ChunkSize, Offset, Directory>() const noexcept
+	{
+		return {directory, index};
+	}
+
+	auto operator*() const noexcept -> reference
+	{
+		return *operator->();
+	}
+
+	auto operator->() const noexcept -> pointer
+	{
+		const auto chunk = static_cast<std::size_t>(index) / ChunkSize;
+		const auto row = static_cast<std::size_t>(index) % ChunkSize;
+		return reinterpret_cast<pointer>(static_cast<byte_type *>((*directory)[chunk]) + Offset) + row;
+	}
+
+	auto operator[](const difference_type n) const noexcept -> reference
+	{
+		return *(*this + n);
+	}
+
+	auto operator++() noexcept -> chunk_iterator&
+	{
+		++index;
+		return *this;
+	}
+
+	auto operator++(int) noexcept -> chunk_iterator
+	{
+		auto copy = *this;
+		++index;
+		return copy;
+	}
+
+	auto operator--() noexcept -> chunk_iterator&
+	{
+		--index;
+		return *this;
+	}
+
+	auto operator--(int) noexcept -> chunk_iterator
+	{
+		auto copy = *this;
+		--index;
+		return copy;
+	}
+
+	auto operator+=(const difference_type n) noexcept -> chunk_iterator&
+	{
+		index += n;
+		return *this;
+	}
+
+	auto operator-=(const difference_type n) noexcept -> chunk_iterator&
+	{
+		index -= n;
+		return *this;
+	}
+
+	[[nodiscard]]
+	friend auto operator+(chunk_iterator it, const difference_type n) noexcept -> chunk_iterator
+	{
+		return it += n;
+	}
+
+	[[nodiscard]]
+	friend auto operator+(const difference_type n, chunk_iterator it) noexcept -> chunk_iterator
+	{
+		return it += n;
+	}
+
+	[[nodiscard]]
+	friend auto operator-(chunk_iterator it, const difference_type n) noexcept -> chunk_iterator
+	{
+		return it -= n;
+	}
+
+	[[nodiscard]]
+	friend auto operator-(const chunk_iterator &lhs, const chunk_iterator &rhs) noexcept -> difference_type
+	{
+		return lhs.index - rhs.index;
+	}
+
+	[[nodiscard]]
+	friend bool operator==(const chunk_iterator &lhs, const chunk_iterator &rhs) noexcept
+	{
+		return lhs.index == rhs.index;
+	}
+
+	[[nodiscard]]
+	friend auto operator<=>(const chunk_iterator &lhs, const chunk_iterator &rhs) noexcept -> std::strong_ordering
+	{
+		return lhs.index <=> rhs.index;
+	}
+
+private:
+	const Directory *directory = nullptr;
+	difference_type index = 0;
+};
+
+template <std::size_t ChunkSize, std::size_t Alignment, typename T, typename, typename Allocator>
+class column_chunks;
+
+// fixed-size chunks of ChunkSize rows, each one a separate Alignment aligned allocation holding
+// every column contiguously; a directory of chunk pointers grows instead of the rows, so growing
+// never moves an element and references stay valid until the element is erased. Moves and swaps
+// keep the chunks, so references survive them too, but iterators (and projections, which hold
+// them) refer to the directory member and have to be retaken from the storage the rows went to
+template <std::size_t ChunkSize, std::size_t Alignment, typename... Ts, std::size_t... Is, typename Allocator>
+class column_chunks<ChunkSize, Alignment, std::tuple<Ts...>, std::index_sequence<Is...>, Allocator>
+{
+	static_assert(ChunkSize > 0U, "a chunk needs at least one row");
+
+	static constexpr std::size_t alignment = std::max({Alignment, alignof(Ts)...});
+
+	using chunk = aligned_chunk<alignment>;
+	using chunk_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<chunk>;
+	using chunk_traits = std::allocator_traits<chunk_allocator>;
+	using directory_type = std::vector<std::byte *, typename std::allocator_traits<Allocator>::template rebind_alloc<std::byte *>>;
+
+	[[nodiscard]]
+	static constexpr auto round_up(const std::size_t bytes, const std::size_t to) noexcept -> std::size_t
+	{
+		return (bytes + to - 1U) / to * to;
+	}
+
+	// byte offset of every column inside a chunk followed by the chunk size
+	static constexpr auto layout = []
+	{
+		std::array<std::size_t, sizeof...(Ts) + 1U> result{};
+		std::size_t offset = 0U;
+		std::size_t i = 0U;
+		(..., (offset = round_up(offset, alignof(Ts)), result[i++] = offset, offset += ChunkSize * sizeof(Ts)));
+		result[i] = offset;
+		return result;
+	}();
+
+	static constexpr std::size_t chunk_units = (layout.back() + sizeof(chunk) - 1U) / sizeof(chunk);
+
+public:
+	using value_type = std::tuple<Ts...>;
+	using allocator_type = Allocator;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = std::tuple<Ts &...>;
+	using const_reference = std::tuple<const Ts &...>;
+	using pointer = std::tuple<Ts *...>;
+	using const_pointer = std::tuple<const Ts *...>;
+	using iterator = std::tuple<chunk_iterator<Ts, ChunkSize, layout[Is], directory_type>...>;
+	using const_iterator = std::tuple<chunk_iterator<const Ts, ChunkSize, layout[Is], directory_type>...>;
+	using reverse_iterator = std::tuple<std::reverse_iterator<std::tuple_element_t<Is, iterator>>...>;
+	using const_reverse_iterator = std::tuple<std::reverse_iterator<std::tuple_element_t<Is, const_iterator>>...>;
+
+	static constexpr std::size_t chunk_size = ChunkSize;
+
+	column_chunks() = default;
+
+	explicit column_chunks(const Allocator &alloc)
+		: allocator{alloc}, directory(alloc)
+	{
+	}
+
+	column_chunks(const column_chunks &that)
+		: column_chunks{that, allocator_type(chunk_traits::select_on_container_copy_construction(that.allocator))}
+	{
+	}
+
+	column_chunks(const column_chunks &that, const Allocator &alloc)
+		: column_chunks{alloc}
+	{
+		reserve(that.count);
+		construct_columns(0U, that.count, [&](auto i, auto p, const size_type n)
+		{
+			std::uninitialized_copy_n(std::get<decltype(i)::value>(that.columns()), n, p);
+		});
+		count = that.count;
+	}
+
+	column_chunks(column_chunks &&that) noexcept
+		: allocator{std::move(that.allocator)},
+		  directory{std::move(that.directory)},
+		  count{std::exchange(that.count, 0U)}
+	{
+	}
+
+	// takes over the chunks if alloc can free them, otherwise moves the rows element-wise
+	column_chunks(column_chunks &&that, const Allocator &alloc)
+		: column_chunks{alloc}
+	{
+		if (allocator == that.allocator)
+		{
+			swap_chunks(that);
+			return;
+		}
+
+		reserve(that.count);
+		construct_columns(0U, that.count, [&](auto i, auto p, const size_type n)
+		{
+			std::uninitialized_move_n(std::get<decltype(i)::value>(that.columns()), n, p);
+		});
+		count = that.count;
+	}
+
+	~column_chunks()
+	{
+		clear();
+		release(0U);
+	}
+
+	auto operator=(const column_chunks &that) -> column_chunks&
+	{
+		if (this != &that)
+		{
+			column_chunks copy{that, propagate_on_copy ? that.get_allocator() : get_allocator()};
+			swap_chunks(copy);
+			if constexpr (propagate_on_copy)
+				std::swap(allocator, copy.allocator);
+		}
+		return *this;
+	}
+
+	auto operator=(column_chunks &&that) noexcept(propagate_on_move || chunk_traits::is_always_equal::value)
+		-> column_chunks&
+	{
+		column_chunks moved{std::move(that), propagate_on_move ? that.get_allocator() : get_allocator()};
+		swap_chunks(moved);
+		if constexpr (propagate_on_move)
+			std::swap(allocator, moved.allocator);
+		return *this;
+	}
+
+	[[nodiscard]]
+	auto get_allocator() const noexcept -> allocator_type
+	{
+		return allocator_type(allocator);
+	}
+
+	template <std::size_t I>
+	[[nodiscard]]
+	auto column() noexcept -> std::ranges::subrange<std::tuple_element_t<I, iterator>>
+	{
+		const auto first = std::get<I>(columns());
+		return {first, first + static_cast<difference_type>(count)};
+	}
+
+	template <std::size_t I>
+	[[nodiscard]]
+	auto column() const noexcept -> std::ranges::subrange<std::tuple_element_t<I, const_iterator>>
+	{
+		const auto first = std::get<I>(columns());
+		return {first, first + static_cast<difference_type>(count)};
+	}
+
+	[[nodiscard]]
+	auto chunk_count() const noexcept -> size_type
+	{
+		return (count + ChunkSize - 1U) / ChunkSize;
+	}
+
+	// first row of every column in chunk k
+	[[nodiscard]]
+	auto chunk_data(const size_type k) noexcept -> pointer
+	{
+		return {reinterpret_cast<Ts *>(directory[k] + layout[Is])...};
+	}
+
+	[[nodiscard]]
+	auto chunk_data(const size_type k) const noexcept -> const_pointer
+	{
+		return {reinterpret_cast<const Ts *>(directory[k] + layout[Is])...};
+	}
+
+	[[nodiscard]]
+	bool empty() const noexcept
+	{
+		return count == 0U;
+	}
+
+	[[nodiscard]]
+	auto size() const noexcept -> size_type
+	{
+		return count;
+	}
+
+	[[nodiscard]]
+	auto max_size() const noexcept -> size_type
+	{
+		return std::min(static_cast<size_type>(std::numeric_limits<difference_type>::max()),
+		                directory.max_size() / 2U * ChunkSize);
+	}
+
+	[[nodiscard]]
+	auto capacity() const noexcept -> size_type
+	{
+		return std::size(directory) * ChunkSize;
+	}
+
+	// adds chunks until new_cap rows fit, existing chunks are never touched
+	void reserve(const size_type new_cap)
+	{
+		if (new_cap <= capacity())
+			return;
+		if (new_cap > max_size())
+			throw std::length_error{"soa::column_chunks: capacity exceeds max_size()"};
+
+		directory.reserve((new_cap + ChunkSize - 1U) / ChunkSize);
+		while (capacity() < new_cap)
+			directory.push_back(reinterpret_cast<std::byte *>(
+				std::to_address(chunk_traits::allocate(allocator, chunk_units))));
+	}
+
+	// frees the chunks past the last row
+	void shrink_to_fit()
+	{
+		release(chunk_count());
+		directory.shrink_to_fit();
+	}
+
+	void clear() noexcept
+	{
+		(..., std::destroy_n(std::get<Is>(columns()), count));
+		count = 0U;
+	}
+
+	template <typename U>
+	void insert(const size_type pos, U &&value)
+	{
+		push_back(std::forward<U>(value));
+		rotate_back(pos, 1U);
+	}
+
+	void insert(const size_type pos, const size_type n, const value_type &value)
+	{
+		if (n == 0U)
+			return;
+
+		reserve(count + n);
+		construct_columns(count, n, [&](auto i, auto p, const size_type k)
+		{
+			std::uninitialized_fill_n(p, k, std::get<decltype(i)::value>(value));
+		});
+		count += n;
+		rotate_back(pos, n);
+	}
+
+	template <typename...Args>
+	void emplace(const size_type pos, Args &&...args)
+	{
+		emplace_back(std::forward<Args>(args)...);
+		rotate_back(pos, 1U);
+	}
+
+	void erase(const size_type first, const size_type last)
+	{
+		if (first == last)
+			return;
+
+		const auto n = last - first;
+		const auto target = columns();
+		(..., std::move(at<Is>(target, last), at<Is>(target, count), at<Is>(target, first)));
+		(..., std::destroy_n(at<Is>(target, count - n), n));
+		count -= n;
+	}
+
+	void push_back(const value_type &value)
+	{
+		emplace_back(std::forward_as_tuple(std::get<Is>(value))...);
+	}
+
+	void push_back(value_type &&value)
+	{
+		emplace_back(std::forward_as_tuple(std::move(std::get<Is>(value)))...);
+	}
+
+	// arguments may refer to our own elements, which stay where they are when a chunk is added
+	template <typename...Args>
+	requires (sizeof...(Args) == sizeof...(Ts))
+	auto emplace_back(Args &&...args) -> reference
+	{
+		reserve(count + 1U);
+
+		auto row = std::forward_as_tuple(std::forward<Args>(args)...);
+		construct_columns(count, 1U, [&](auto i, auto p, size_type)
+		{
+			std::apply([&](auto &&...xs)
+			{
+				std::construct_at(std::addressof(*p), std::forward<decltype(xs)>(xs)...);
+			}, std::get<decltype(i)::value>(std::move(row)));
+		});
+
+		++count;
+		const auto target = columns();
+		return {*at<Is>(target, count - 1U)...};
+	}
+
+	// appends n rows, column I copied from firsts[I]
+	template <typename... Its>
+	void append(const size_type n, Its... firsts)
+	{
+		reserve(count + n);
+
+		const std::tuple<Its...> sources{firsts...};
+		construct_columns(count, n, [&](auto i, auto p, const size_type k)
+		{
+			std::uninitialized_copy_n(std::get<decltype(i)::value>(sources), k, p);
+		});
+		count += n;
+	}
+
+	void pop_back()
+	{
+		--count;
+		const auto target = columns();
+		(..., std::destroy_at(std::addressof(*at<Is>(target, count))));
+	}
+
+	void resize(const size_type n)
+	{
+		if (n <= count)
+		{
+			erase(n, count);
+			return;
+		}
+
+		reserve(n);
+		construct_columns(count, n - count, [](auto, auto p, const size_type k)
+		{
+			std::uninitialized_value_construct_n(p, k);
+		});
+		count = n;
+	}
+
+	void resize(const size_type n, const value_type &value)
+	{
+		if (n <= count)
+			erase(n, count);
+		else
+			insert(count, n - count, value);
+	}
+
+	// like the standard containers, allocators that do not propagate on swap have to compare equal
+	void swap(column_chunks &other) noexcept
+	{
+		if constexpr (chunk_traits::propagate_on_container_swap::value)
+			std::swap(allocator, other.allocator);
+		swap_chunks(other);
+	}
+
+private:
+	static constexpr bool propagate_on_copy = chunk_traits::propagate_on_container_copy_assignment::value;
+	static constexpr bool propagate_on_move = chunk_traits::propagate_on_container_move_assignment::value;
+
+	[[no_unique_address]] chunk_allocator allocator{};
+	directory_type directory;
+	size_type count = 0U;
+
+	[[nodiscard]]
+	auto columns() noexcept -> iterator
+	{
+		return {std::tuple_element_t<Is, iterator>{&directory, 0}...};
+	}
+
+	[[nodiscard]]
+	auto columns() const noexcept -> const_iterator
+	{
+		return {std::tuple_element_t<Is, const_iterator>{&directory, 0}...};
+	}
+
+	template <std::size_t I, typename It>
+	[[nodiscard]]
+	static auto at(const It &target, const size_type i) noexcept
+	{
+		return std::get<I>(target) + static_cast<difference_type>(i);
+	}
+
+	// frees every chunk from index first on
+	void release(const size_type first) noexcept
+	{
+		for (auto k = first; k < std::size(directory); ++k)
+			chunk_traits::deallocate(allocator, reinterpret_cast<chunk *>(directory[k]), chunk_units);
+		directory.resize(std::min(first, std::size(directory)));
+	}
+
+	// exchanges everything but the allocators, the directories are swapped along with their
+	// own allocators, which compare equal whenever the chunk allocators do
+	void swap_chunks(column_chunks &other) noexcept
+	{
+		directory.swap(other.directory);
+		std::swap(count, other.count);
+	}
+
+	// constructs rows [first, first + n) column by column, destroying finished columns on failure
+	template <typename F>
+	void construct_columns(const size_type first, const size_type n, F &&construct)
+	{
+		const auto target = columns();
+		size_type done = 0U;
+		try
+		{
+			(..., (construct(std::integral_constant<std::size_t, Is>{}, at<Is>(target, first), n), ++done));
+		}
+		catch (...)
+		{
+			(..., (Is < done ? static_cast<void>(std::destroy_n(at<Is>(target, first), n)) : void()));
+			throw;
+		}
+	}
+
+	// moves the trailing n rows in front of pos
+	void rotate_back(const size_type pos, const size_type n)
+	{
+		const auto target = columns();
+		(..., std::rotate(at<Is>(target, pos), at<Is>(target, count - n), at<Is>(target, count)));
+	}
+};
+} // namespace impl
+} // namespace soa
+
+#endif // SOA_COLUMN_CHUNKS_H
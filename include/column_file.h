@@ -0,0 +1,361 @@
+#ifndef SOA_COLUMN_FILE_H
+#define SOA_COLUMN_FILE_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "struct_array.h"
+#include "struct_array_view.h"
+#include "to_tuple.h"
+
+// Columnar files: a header describing every field (kind, size, alignment, offset) and the row
+// count, followed by the raw columns, each starting on a page boundary. Files are mapped
+// read-only and used in place, so opening one costs a few syscalls and a projection only faults
+// in the pages of the columns it reads. Fields have to be trivially copyable, files are only
+// readable on machines with the same byte order. Mapping requires POSIX mmap.
+namespace soa
+{
+namespace impl
+{
+inline static constexpr std::array<char, 8U> column_file_magic{'S', 'O', 'A', 'C', 'O', 'L', 'S', '\0'};
+inline static constexpr std::uint32_t column_file_version = 1U;
+
+// columns are aligned to at least this many bytes, more if the page size is larger
+inline static constexpr std::size_t column_file_alignment = 4096U;
+
+enum class field_kind : std::uint32_t
+{
+	boolean,
+	signed_integer,
+	unsigned_integer,
+	floating_point,
+	bytes
+};
+
+struct column_file_field
+{
+	std::uint64_t offset;
+	std::uint32_t kind;
+	std::uint32_t size;
+	std::uint32_t alignment;
+	std::uint32_t reserved;
+};
+
+struct column_file_header
+{
+	std::array<char, 8U> magic;
+	std::uint32_t version;
+	std::uint32_t little_endian;
+	std::uint64_t count;
+	std::uint64_t alignment;
+	std::uint32_t fields;
+	std::uint32_t reserved;
+};
+
+template <typename T>
+[[nodiscard]]
+constexpr auto kind_of() noexcept -> field_kind
+{
+	if constexpr (std::is_same_v<T, bool>)
+		return field_kind::boolean;
+	else if constexpr (std::is_enum_v<T>)
+		return kind_of<std::underlying_type_t<T>>();
+	else if constexpr (std::is_integral_v<T>)
+		return std::is_signed_v<T> ? field_kind::signed_integer : field_kind::unsigned_integer;
+	else if constexpr (std::is_floating_point_v<T>)
+		return field_kind::floating_point;
+	else
+		return field_kind::bytes;
+}
+
+template <typename T>
+[[nodiscard]]
+constexpr auto field_of(const std::uint64_t offset) noexcept -> column_file_field
+{
+	return {offset, static_cast<std::uint32_t>(kind_of<T>()), sizeof(T), alignof(T), 0U};
+}
+
+[[nodiscard]]
+inline auto column_alignment() noexcept -> std::size_t
+{
+	const auto page = ::sysconf(_SC_PAGESIZE);
+	return std::max(column_file_alignment, page > 0 ? static_cast<std::size_t>(page) : std::size_t{0U});
+}
+
+[[nodiscard]]
+constexpr auto round_up(const std::uint64_t bytes, const std::uint64_t to) noexcept -> std::uint64_t
+{
+	return (bytes + to - 1U) / to * to;
+}
+
+// file offset of every column for count rows
+template <typename... Ts>
+[[nodiscard]]
+auto column_offsets(const std::uint64_t count, const std::uint64_t alignment) noexcept
+	-> std::array<std::uint64_t, sizeof...(Ts)>
+{
+	std::array<std::uint64_t, sizeof...(Ts)> result{};
+	auto offset = round_up(sizeof(column_file_header) + sizeof...(Ts) * sizeof(column_file_field), alignment);
+	std::size_t i = 0U;
+	(..., (result[i++] = offset, offset = round_up(offset + count * sizeof(Ts), alignment)));
+	return result;
+}
+
+template <typename T>
+void write_bytes(std::ofstream &out, const T &value)
+{
+	out.write(reinterpret_cast<const char *>(std::addressof(value)), sizeof(T));
+}
+
+inline void write_padding(std::ofstream &out, std::uint64_t bytes)
+{
+	static constexpr std::array<char, 512U> zeros{};
+	for (; bytes > 0U; bytes -= std::min<std::uint64_t>(bytes, zeros.size()))
+		out.write(std::data(zeros), static_cast<std::streamsize>(std::min<std::uint64_t>(bytes, zeros.size())));
+}
+
+template <typename It>
+void write_column(std::ofstream &out, It first, const std::size_t n)
+{
+	using U = std::iter_value_t<It>;
+	if constexpr (std::contiguous_iterator<It>)
+		out.write(reinterpret_cast<const char *>(std::to_address(first)), static_cast<std::streamsize>(n * sizeof(U)));
+	else
+		for (std::size_t i = 0U; i < n; ++i, ++first)
+			write_bytes(out, static_cast<const U &>(*first));
+}
+
+template <typename T, typename A, std::size_t... Is>
+void save_columns(const std::filesystem::path &path, const A &array, std::index_sequence<Is...>)
+{
+	using columns = to_tuple_t<T>;
+	static_assert((... && std::is_trivially_copyable_v<std::tuple_element_t<Is, columns>>),
+	              "only trivially copyable fields can be stored in a column file");
+
+	const auto count = static_cast<std::uint64_t>(std::size(array));
+	const auto alignment = column_alignment();
+	const auto offsets = column_offsets<std::tuple_element_t<Is, columns>...>(count, alignment);
+
+	std::ofstream out{path, std::ios::binary | std::ios::trunc};
+	if (!out)
+		throw std::system_error{errno, std::generic_category(), "soa::save_columns: cannot open " + path.string()};
+
+	write_bytes(out, column_file_header{
+		column_file_magic, column_file_version, std::endian::native == std::endian::little, count, alignment,
+		sizeof...(Is), 0U
+	});
+	(..., write_bytes(out, field_of<std::tuple_element_t<Is, columns>>(offsets[Is])));
+
+	auto position = sizeof(column_file_header) + sizeof...(Is) * sizeof(column_file_field);
+	(..., [&]
+	{
+		write_padding(out, offsets[Is] - position);
+		write_column(out, std::get<0U>(array.template project<Is>().first), count);
+		position = offsets[Is] + count * sizeof(std::tuple_element_t<Is, columns>);
+	}());
+
+	out.flush();
+	if (!out)
+		throw std::system_error{errno, std::generic_category(), "soa::save_columns: cannot write " + path.string()};
+}
+
+// read-only mapping of a whole file
+class file_mapping
+{
+public:
+	file_mapping() noexcept = default;
+
+	explicit file_mapping(const std::filesystem::path &path)
+	{
+		const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (fd < 0)
+			throw std::system_error{errno, std::generic_category(), "soa::file_mapping: cannot open " + path.string()};
+
+		struct ::stat status{};
+		if (::fstat(fd, &status) != 0)
+		{
+			const auto error = errno;
+			::close(fd);
+			throw std::system_error{error, std::generic_category(), "soa::file_mapping: cannot stat " + path.string()};
+		}
+
+		length = static_cast<std::size_t>(status.st_size);
+		if (length != 0U)
+		{
+			auto *const mapped = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+			if (mapped == MAP_FAILED)
+			{
+				const auto error = errno;
+				::close(fd);
+				throw std::system_error{error, std::generic_category(), "soa::file_mapping: cannot map " + path.string()};
+			}
+			address = static_cast<const std::byte *>(mapped);
+		}
+		::close(fd);
+	}
+
+	file_mapping(const file_mapping &) = delete;
+
+	file_mapping(file_mapping &&that) noexcept
+		: address{std::exchange(that.address, nullptr)},
+		  length{std::exchange(that.length, 0U)}
+	{
+	}
+
+	~file_mapping()
+	{
+		if (address != nullptr)
+			::munmap(const_cast<std::byte *>(address), length);
+	}
+
+	auto operator=(const file_mapping &) -> file_mapping& = delete;
+
+	auto operator=(file_mapping &&that) noexcept -> file_mapping&
+	{
+		file_mapping moved{std::move(that)};
+		std::swap(address, moved.address);
+		std::swap(length, moved.length);
+		return *this;
+	}
+
+	[[nodiscard]]
+	auto data() const noexcept -> const std::byte*
+	{
+		return address;
+	}
+
+	[[nodiscard]]
+	auto size() const noexcept -> std::size_t
+	{
+		return length;
+	}
+
+private:
+	const std::byte *address = nullptr;
+	std::size_t length = 0U;
+};
+
+// checks the header against T and returns the columns inside the mapping
+template <typename T, std::size_t... Is>
+[[nodiscard]]
+auto map_columns(const file_mapping &mapping, std::index_sequence<Is...>) -> struct_array_view<const T>
+{
+	using columns = to_tuple_t<T>;
+	static_assert((... && std::is_trivially_copyable_v<std::tuple_element_t<Is, columns>>),
+	              "only trivially copyable fields can be stored in a column file");
+
+	const auto fail = [](const char *const what)
+	{
+		throw std::runtime_error{std::string{"soa::mapped_struct_array: "} + what};
+	};
+
+	constexpr auto header_size = sizeof(column_file_header) + sizeof...(Is) * sizeof(column_file_field);
+	if (mapping.size() < header_size)
+		fail("file too small for the header");
+
+	column_file_header header;
+	std::memcpy(&header, mapping.data(), sizeof(header));
+	if (header.magic != column_file_magic)
+		fail("not a column file");
+	if (header.version != column_file_version)
+		fail("unsupported version");
+	if ((header.little_endian != 0U) != (std::endian::native == std::endian::little))
+		fail("byte order mismatch");
+	if (header.fields != sizeof...(Is))
+		fail("field count mismatch");
+
+	std::array<column_file_field, sizeof...(Is)> fields;
+	std::memcpy(std::data(fields), mapping.data() + sizeof(header), sizeof(fields));
+
+	const auto check = [&]<typename U>(const column_file_field &field, std::type_identity<U>)
+	{
+		const auto expected = field_of<U>(field.offset);
+		if (field.kind != expected.kind || field.size != expected.size || field.alignment != expected.alignment)
+			fail("field type mismatch");
+		if (field.offset % alignof(U) != 0U || field.offset > mapping.size()
+			|| header.count > (mapping.size() - field.offset) / sizeof(U))
+			fail("column out of bounds");
+		return reinterpret_cast<const U *>(mapping.data() + field.offset);
+	};
+
+	return {{check(fields[Is], std::type_identity<std::tuple_element_t<Is, columns>>{})...},
+	        static_cast<std::size_t>(header.count)};
+}
+} // namespace impl
+
+// writes the rows of array to a column file
+template <typename T, typename I, typename S>
+void save_columns(const std::filesystem::path &path, const impl::struct_array_impl<T, I, S> &array)
+{
+	impl::save_columns<T>(path, array, I{});
+}
+
+template <typename T, typename I, typename U>
+void save_columns(const std::filesystem::path &path, const impl::struct_array_view_impl<T, I, U> &view)
+{
+	impl::save_columns<std::remove_const_t<T>>(path, view, I{});
+}
+
+// a column file mapped read-only, usable as a struct_array_view<const T> for as long as it lives
+template <typename T>
+class mapped_struct_array : public struct_array_view<const T>
+{
+public:
+	using view_type = struct_array_view<const T>;
+
+	explicit mapped_struct_array(const std::filesystem::path &path)
+		: mapped_struct_array{impl::file_mapping{path}}
+	{
+	}
+
+	mapped_struct_array(mapped_struct_array &&that) noexcept
+		: view_type{std::exchange(static_cast<view_type &>(that), view_type{})},
+		  mapping{std::move(that.mapping)}
+	{
+	}
+
+	auto operator=(mapped_struct_array &&that) noexcept -> mapped_struct_array&
+	{
+		static_cast<view_type &>(*this) = std::exchange(static_cast<view_type &>(that), view_type{});
+		mapping = std::move(that.mapping);
+		return *this;
+	}
+
+	[[nodiscard]]
+	auto view() const noexcept -> view_type
+	{
+		return *this;
+	}
+
+private:
+	impl::file_mapping mapping;
+
+	explicit mapped_struct_array(impl::file_mapping &&file)
+		: view_type{impl::map_columns<T>(file, std::make_index_sequence<std::tuple_size_v<to_tuple_t<T>>>{})},
+		  mapping{std::move(file)}
+	{
+	}
+};
+} // namespace soa
+
+#endif // SOA_COLUMN_FILE_H
@@ -0,0 +1,288 @@
+#ifndef SOA_COLUMN_GROUPS_H
+#define SOA_COLUMN_GROUPS_H
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace soa
+{
+namespace impl
+{
+// iterator over one field of an interleaved column, consecutive elements are Stride bytes apart
+template <typename T, std::size_t Stride>
+class stride_iterator
+{
+	using byte_type = std::conditional_t<std::is_const_v<T>, const std::byte, std::byte>;
+
+public:
+	using iterator_concept = std::random_access_iterator_tag;
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = std::remove_cv_t<T>;
+	using difference_type = std::ptrdiff_t;
+	using reference = T&;
+	using pointer = T*;
+
+	stride_iterator() noexcept = default;
+
+	explicit stride_iterator(byte_type *const address) noexcept
+		: address{address}
+	{
+	}
+
+	// conversion to const iterator
+	operator stride_iterator<const T, Stride>() const noexcept
+	{
+		return stride_iterator<const T, Stride>{address};
+	}
+
+	auto operator*() const noexcept -> reference
+	{
+		return *operator->();
+	}
+
+	auto operator->() const noexcept -> pointer
+	{
+		return reinterpret_cast<pointer>(address);
+	}
+
+	auto operator[](const difference_type n) const noexcept -> reference
+	{
+		return *(*this + n);
+	}
+
+	auto operator++() noexcept -> stride_iterator&
+	{
+		address += Stride;
+		return *this;
+	}
+
+	auto operator++(int) noexcept -> stride_iterator
+	{
+		auto copy = *this;
+		address += Stride;
+		return copy;
+	}
+
+	auto operator--() noexcept -> stride_iterator&
+	{
+		address -= Stride;
+		return *this;
+	}
+
+	auto operator--(int) noexcept -> stride_iterator
+	{
+		auto copy = *this;
+		address -= Stride;
+		return copy;
+	}
+
+	auto operator+=(const difference_type n) noexcept -> stride_iterator&
+	{
+		address += n * static_cast<difference_type>(Stride);
+		return *this;
+	}
+
+	auto operator-=(const difference_type n) noexcept -> stride_iterator&
+	{
+		address -= n * static_cast<difference_type>(Stride);
+		return *this;
+	}
+
+	[[nodiscard]]
+	friend auto operator+(stride_iterator it, const difference_type n) noexcept -> stride_iterator
+	{
+		return it += n;
+	}
+
+	[[nodiscard]]
+	friend auto operator+(const difference_type n, stride_iterator it) noexcept -> stride_iterator
+	{
+		return it += n;
+	}
+
+	[[nodiscard]]
+	friend auto operator-(stride_iterator it, const difference_type n) noexcept -> stride_iterator
+	{
+		return it -= n;
+	}
+
+	[[nodiscard]]
+	friend auto operator-(const stride_iterator &lhs, const stride_iterator &rhs) noexcept -> difference_type
+	{
+		return (lhs.address - rhs.address) / static_cast<difference_type>(Stride);
+	}
+
+	[[nodiscard]]
+	friend bool operator==(const stride_iterator &lhs, const stride_iterator &rhs) noexcept
+	{
+		return lhs.address == rhs.address;
+	}
+
+	[[nodiscard]]
+	friend auto operator<=>(const stride_iterator &lhs, const stride_iterator &rhs) noexcept -> std::strong_ordering
+	{
+		return lhs.address <=> rhs.address;
+	}
+
+private:
+	byte_type *address = nullptr;
+};
+
+template <std::size_t Alignment, typename Groups, typename T, typename>
+struct group_addressing;
+
+// fields listed together in one of Groups (each an index_sequence) share an interleaved column of
+// small records, every other field gets a plain array; the columns follow each other in one block,
+// each starting on an Alignment boundary. Iterators over grouped fields step by the record size
+template <std::size_t Alignment, typename... Groups, typename... Ts, std::size_t... Is>
+struct group_addressing<Alignment, std::tuple<Groups...>, std::tuple<Ts...>, std::index_sequence<Is...>>
+{
+	static constexpr std::size_t alignment = std::max({Alignment, alignof(Ts)...});
+
+	static_assert((alignment & (alignment - 1U)) == 0U, "alignment has to be a power of two");
+
+private:
+	static constexpr std::size_t fields = sizeof...(Ts);
+
+	[[nodiscard]]
+	static constexpr auto round_up(const std::size_t bytes, const std::size_t to) noexcept -> std::size_t
+	{
+		return (bytes + to - 1U) / to * to;
+	}
+
+	template <std::size_t... Js>
+	[[nodiscard]]
+	static constexpr auto members(std::index_sequence<Js...>) noexcept -> std::array<std::size_t, sizeof...(Js)>
+	{
+		return {Js...};
+	}
+
+	// column of every field, the field's offset inside a record of that column and the record size
+	struct placement_table
+	{
+		std::array<std::size_t, fields> column{};
+		std::array<std::size_t, fields> offset{};
+		std::array<std::size_t, fields> stride{};
+		std::size_t columns = 0U;
+		bool valid = true;
+	};
+
+	static constexpr auto placement = []
+	{
+		constexpr std::array<std::size_t, fields> sizes{sizeof(Ts)...};
+		constexpr std::array<std::size_t, fields> alignments{alignof(Ts)...};
+
+		placement_table result{};
+		std::array<std::size_t, fields> group_of{};
+		group_of.fill(fields);
+
+		std::size_t group = 0U;
+		(..., [&]
+		{
+			const auto indices = members(Groups{});
+			if (std::empty(indices))
+				result.valid = false;
+
+			std::size_t offset = 0U;
+			std::size_t align = 1U;
+			for (const auto i : indices)
+			{
+				if (i >= fields || group_of[i] != fields)
+				{
+					result.valid = false;
+					return;
+				}
+				group_of[i] = group;
+				offset = round_up(offset, alignments[i]);
+				result.offset[i] = offset;
+				offset += sizes[i];
+				align = std::max(align, alignments[i]);
+			}
+			for (const auto i : indices)
+				result.stride[i] = round_up(offset, align);
+			++group;
+		}());
+
+		// columns are ordered by their first field
+		std::array<std::size_t, sizeof...(Groups) + 1U> column_of_group{};
+		column_of_group.fill(fields);
+		for (std::size_t i = 0U; i < fields; ++i)
+		{
+			if (group_of[i] == fields)
+			{
+				result.stride[i] = sizes[i];
+				result.column[i] = result.columns++;
+			}
+			else
+			{
+				if (column_of_group[group_of[i]] == fields)
+					column_of_group[group_of[i]] = result.columns++;
+				result.column[i] = column_of_group[group_of[i]];
+			}
+		}
+		return result;
+	}();
+
+	static_assert(placement.valid, "every group needs distinct, valid field indices and no field may be in two groups");
+
+	// record size of every column
+	static constexpr auto column_strides = []
+	{
+		std::array<std::size_t, fields> result{};
+		for (std::size_t i = 0U; i < fields; ++i)
+			result[placement.column[i]] = placement.stride[i];
+		return result;
+	}();
+
+	// a field alone in its column is a plain array
+	template <typename T, std::size_t I>
+	using field_iterator = std::conditional_t<placement.stride[I] == sizeof(T), T *,
+		stride_iterator<T, placement.stride[I]>>;
+
+public:
+	using iterator = std::tuple<field_iterator<Ts, Is>...>;
+	using const_iterator = std::tuple<field_iterator<const Ts, Is>...>;
+
+	[[nodiscard]]
+	static constexpr auto capacity_for(const std::size_t count) noexcept -> std::size_t
+	{
+		return count;
+	}
+
+	[[nodiscard]]
+	static constexpr auto bytes_for(const std::size_t capacity) noexcept -> std::size_t
+	{
+		std::size_t bytes = 0U;
+		for (std::size_t k = 0U; k < placement.columns; ++k)
+			bytes += round_up(capacity * column_strides[k], alignment);
+		return bytes;
+	}
+
+	[[nodiscard]]
+	static auto carve(std::byte *const block, const std::size_t capacity) noexcept -> iterator
+	{
+		std::array<std::size_t, fields> starts{};
+		for (std::size_t k = 1U; k < placement.columns; ++k)
+			starts[k] = starts[k - 1U] + round_up(capacity * column_strides[k - 1U], alignment);
+
+		const auto at = [&]<typename It>(std::type_identity<It>, const std::size_t i) noexcept -> It
+		{
+			auto *const first = block + starts[placement.column[i]] + placement.offset[i];
+			if constexpr (std::is_pointer_v<It>)
+				return reinterpret_cast<It>(first);
+			else
+				return It{first};
+		};
+		return iterator{at(std::type_identity<field_iterator<Ts, Is>>{}, Is)...};
+	}
+};
+} // namespace impl
+} // namespace soa
+
+#endif // SOA_COLUMN_GROUPS_H
@@ -0,0 +1,451 @@
+#ifndef SOA_COLUMN_INDEX_H
+#define SOA_COLUMN_INDEX_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "bitmask.h"
+#include "sort.h"
+#include "to_tuple.h"
+
+// Secondary indexes over column I of an array of T, i.e. a struct_array<T, Layout> (any layout)
+// or anything else with project<I>():
+//
+//   hash_index<T, I>          equality lookups, open addressing over row numbers
+//   sorted_index<T, I>        range lookups, the keys in order together with their rows
+//   zone_map<T, I, BlockRows> min and max of every block of BlockRows rows, lets scans skip blocks
+//
+// An index does not observe the array. The owner calls changed(array, first) after rows
+// [first, size()) were appended, erased or replaced (rows below first unchanged) and
+// modified(array, pos) after row pos was changed in place; an index either follows the change
+// incrementally or marks itself stale, and rebuild(array) brings a stale index up to date.
+// Lookups check that the index covers the array and throw std::invalid_argument otherwise.
+// indexed_struct_array.h does this bookkeeping for a set of indexes.
+namespace soa
+{
+namespace impl
+{
+template <std::size_t I, typename A>
+[[nodiscard]]
+auto key_column(const A &array) noexcept
+{
+	return std::get<0U>(array.template project<I>().first);
+}
+
+inline void check_index(const char *const message, const bool current)
+{
+	if (!current)
+		throw std::invalid_argument{message};
+}
+} // namespace impl
+
+// equality index: a power of two table of (row, hash tag) entries with linear probing, filled to
+// at most three quarters. Keys are not copied, a probe only reads the column for entries whose
+// tag matches. Appends are inserted as they come, every other change makes the index stale.
+// Meant for keys with few duplicates, every copy of a key sits in the same probe run
+template <typename T, std::size_t I>
+class hash_index
+{
+public:
+	using key_type = std::tuple_element_t<I, to_tuple_t<T>>;
+	using size_type = std::size_t;
+
+	static constexpr std::size_t column = I;
+
+	template <typename A>
+	void rebuild(const A &array)
+	{
+		table.clear();
+		indexed = 0U;
+		is_stale = true;
+		insert(array, std::size(array));
+		is_stale = false;
+	}
+
+	template <typename A>
+	void changed(const A &array, const size_type first)
+	{
+		if (is_stale || first != indexed)
+		{
+			is_stale = true;
+			return;
+		}
+
+		is_stale = true;
+		insert(array, std::size(array));
+		is_stale = false;
+	}
+
+	template <typename A>
+	void modified(const A &, size_type) noexcept
+	{
+		is_stale = true;
+	}
+
+	[[nodiscard]]
+	bool stale() const noexcept
+	{
+		return is_stale;
+	}
+
+	// rows whose key equals key, ascending
+	template <typename A>
+	[[nodiscard]]
+	auto rows(const A &array, const key_type &key) const -> std::vector<size_type>
+	{
+		std::vector<size_type> result;
+		probe(array, key, [&](const size_type row)
+		{
+			result.push_back(row);
+			return true;
+		});
+		std::sort(std::begin(result), std::end(result));
+		return result;
+	}
+
+	template <typename A>
+	[[nodiscard]]
+	bool contains(const A &array, const key_type &key) const
+	{
+		bool found = false;
+		probe(array, key, [&](size_type)
+		{
+			found = true;
+			return false;
+		});
+		return found;
+	}
+
+private:
+	static constexpr std::uint32_t no_row = static_cast<std::uint32_t>(-1);
+
+	struct entry
+	{
+		std::uint32_t row;
+		std::uint32_t tag;
+	};
+
+	std::vector<entry> table;
+	size_type indexed = 0U;
+	bool is_stale = false;
+
+	// Fibonacci hashing spreads identity hashes of integers over the whole word; the high bits
+	// pick the slot, the low half is the tag
+	template <typename K>
+	[[nodiscard]]
+	static auto hash_of(const K &key) noexcept -> std::uint64_t
+	{
+		return static_cast<std::uint64_t>(std::hash<K>{}(key)) * 0x9E3779B97F4A7C15ULL;
+	}
+
+	[[nodiscard]]
+	auto slot_of(const std::uint64_t hash) const noexcept -> size_type
+	{
+		return static_cast<size_type>(hash >> (64 - std::countr_zero(std::size(table))));
+	}
+
+	void place(const std::uint32_t row, const std::uint64_t hash) noexcept
+	{
+		const auto mask = std::size(table) - 1U;
+		auto slot = slot_of(hash);
+		while (table[slot].row != no_row)
+			slot = (slot + 1U) & mask;
+		table[slot] = {row, static_cast<std::uint32_t>(hash)};
+	}
+
+	// adds rows [indexed, n), growing the table first if needed
+	template <typename A>
+	void insert(const A &array, const size_type n)
+	{
+		if (n >= no_row)
+			throw std::length_error{"soa::hash_index: too many rows"};
+
+		const auto keys = impl::key_column<I>(array);
+		if (n * 4U > std::size(table) * 3U)
+		{
+			std::vector<entry> old(std::bit_ceil(std::max<size_type>(n * 4U / 3U + 1U, 16U)), entry{no_row, 0U});
+			old.swap(table);
+			for (const auto e : old)
+				if (e.row != no_row)
+					place(e.row, hash_of(keys[static_cast<std::ptrdiff_t>(e.row)]));
+		}
+
+		for (; indexed < n; ++indexed)
+			place(static_cast<std::uint32_t>(indexed), hash_of(keys[static_cast<std::ptrdiff_t>(indexed)]));
+	}
+
+	// calls f(row) for every row with an equal key until f returns false
+	template <typename A, typename F>
+	void probe(const A &array, const key_type &key, F &&f) const
+	{
+		impl::check_index("soa::hash_index: index is out of date", !is_stale && indexed == std::size(array));
+		if (std::empty(table))
+			return;
+
+		const auto keys = impl::key_column<I>(array);
+		const auto hash = hash_of(key);
+		const auto tag = static_cast<std::uint32_t>(hash);
+		const auto mask = std::size(table) - 1U;
+		for (auto slot = slot_of(hash); table[slot].row != no_row; slot = (slot + 1U) & mask)
+		{
+			const auto e = table[slot];
+			if (e.tag == tag && keys[static_cast<std::ptrdiff_t>(e.row)] == key && !f(size_type{e.row}))
+				return;
+		}
+	}
+};
+
+// range index: the keys in ascending order next to the rows they come from, so a lookup is a
+// binary search over a plain array and returns a slice of rows. Appends whose keys do not go
+// below the largest indexed key (timestamps, ids) are added in place, other changes make the
+// index stale. The build sorts through sort.h, i.e. radix sorts arithmetic keys
+template <typename T, std::size_t I>
+class sorted_index
+{
+public:
+	using key_type = std::tuple_element_t<I, to_tuple_t<T>>;
+	using size_type = std::size_t;
+
+	static constexpr std::size_t column = I;
+
+	template <typename A>
+	void rebuild(const A &array)
+	{
+		const auto n = std::size(array);
+		const auto values = impl::key_column<I>(array);
+
+		is_stale = true;
+		std::vector<key_type> unsorted(values, values + static_cast<std::ptrdiff_t>(n));
+		std::less<> comp{};
+		order = impl::sort_permutation<true>(std::data(unsorted), n, comp);
+
+		keys.clear();
+		keys.reserve(n);
+		for (const auto row : order)
+			keys.push_back(unsorted[row]);
+		is_stale = false;
+	}
+
+	template <typename A>
+	void changed(const A &array, const size_type first)
+	{
+		const auto n = std::size(array);
+		if (is_stale || first != std::size(order))
+		{
+			is_stale = true;
+			return;
+		}
+
+		const auto values = impl::key_column<I>(array);
+		const auto begin = values + static_cast<std::ptrdiff_t>(first);
+		const auto end = values + static_cast<std::ptrdiff_t>(n);
+		if (!std::is_sorted(begin, end) || (!std::empty(keys) && first < n && *begin < keys.back()))
+		{
+			is_stale = true;
+			return;
+		}
+
+		is_stale = true;
+		keys.insert(std::end(keys), begin, end);
+		for (auto row = first; row < n; ++row)
+			order.push_back(row);
+		is_stale = false;
+	}
+
+	template <typename A>
+	void modified(const A &, size_type) noexcept
+	{
+		is_stale = true;
+	}
+
+	[[nodiscard]]
+	bool stale() const noexcept
+	{
+		return is_stale;
+	}
+
+	// rows with lo <= key <= hi, ordered by key
+	template <typename A>
+	[[nodiscard]]
+	auto rows(const A &array, const key_type &lo, const key_type &hi) const
+		-> std::span<const size_type>
+	{
+		impl::check_index("soa::sorted_index: index is out of date", !is_stale && std::size(order) == std::size(array));
+
+		const auto first = std::lower_bound(std::begin(keys), std::end(keys), lo);
+		const auto last = std::upper_bound(first, std::end(keys), hi);
+		return std::span<const size_type>{std::data(order), std::size(order)}.subspan(
+			static_cast<size_type>(first - std::begin(keys)), static_cast<size_type>(last - first));
+	}
+
+	// rows whose key equals key
+	template <typename A>
+	[[nodiscard]]
+	auto rows(const A &array, const key_type &key) const -> std::span<const size_type>
+	{
+		return rows(array, key, key);
+	}
+
+private:
+	std::vector<key_type> keys;
+	std::vector<size_type> order;
+	bool is_stale = false;
+};
+
+// block skipping index: the smallest and largest key of every block of BlockRows rows. changed
+// recomputes the blocks from the one holding first on and modified the one block of pos, so it
+// only goes stale if that throws
+template <typename T, std::size_t I, std::size_t BlockRows = 4096U>
+class zone_map
+{
+	static_assert(BlockRows > 0U, "blocks need at least one row");
+
+public:
+	using key_type = std::tuple_element_t<I, to_tuple_t<T>>;
+	using size_type = std::size_t;
+
+	static constexpr std::size_t column = I;
+	static constexpr std::size_t block_rows = BlockRows;
+
+	template <typename A>
+	void rebuild(const A &array)
+	{
+		bounds.clear();
+		indexed = 0U;
+		is_stale = false;
+		changed(array, 0U);
+	}
+
+	template <typename A>
+	void changed(const A &array, const size_type first)
+	{
+		if (is_stale)
+			return;
+
+		const auto n = std::size(array);
+		auto row = std::min(first, indexed);
+		is_stale = true;
+
+		// appends widen a partly filled last block instead of reading it again
+		if (row == indexed && row % BlockRows != 0U && row < n)
+		{
+			const auto end = std::min(n, (row / BlockRows + 1U) * BlockRows);
+			const auto tail = bounds_of(array, row, end);
+			auto &last = bounds.back();
+			last.min = tail.min < last.min ? tail.min : last.min;
+			last.max = last.max < tail.max ? tail.max : last.max;
+			row = end;
+		}
+		else
+			row = row / BlockRows * BlockRows;
+
+		bounds.resize((row + BlockRows - 1U) / BlockRows);
+		for (; row < n; row += BlockRows)
+			bounds.push_back(bounds_of(array, row, std::min(n, row + BlockRows)));
+		indexed = n;
+		is_stale = false;
+	}
+
+	template <typename A>
+	void modified(const A &array, const size_type pos)
+	{
+		if (!is_stale)
+		{
+			const auto first = pos / BlockRows * BlockRows;
+			bounds[pos / BlockRows] = bounds_of(array, first, std::min(indexed, first + BlockRows));
+		}
+	}
+
+	[[nodiscard]]
+	bool stale() const noexcept
+	{
+		return is_stale;
+	}
+
+	[[nodiscard]]
+	auto blocks() const noexcept -> size_type
+	{
+		return std::size(bounds);
+	}
+
+	// rows of the blocks that may hold a key in [lo, hi]
+	template <typename A>
+	[[nodiscard]]
+	auto candidates(const A &array, const key_type &lo, const key_type &hi) const -> bitmask
+	{
+		check(array);
+
+		bitmask result{indexed};
+		for_each_block(lo, hi, [&](const size_type first, const size_type last) { result.set_range(first, last); });
+		return result;
+	}
+
+	// rows with lo <= key <= hi, only the blocks that may hold such a key are read
+	template <typename A>
+	[[nodiscard]]
+	auto rows(const A &array, const key_type &lo, const key_type &hi) const -> bitmask
+	{
+		check(array);
+
+		const auto keys = impl::key_column<I>(array);
+		bitmask result{indexed};
+		for_each_block(lo, hi, [&](const size_type first, const size_type last)
+		{
+			for (auto row = first; row < last; ++row)
+			{
+				const auto &key = keys[static_cast<std::ptrdiff_t>(row)];
+				result.set(row, !(key < lo) && !(hi < key));
+			}
+		});
+		return result;
+	}
+
+private:
+	struct block_bounds
+	{
+		key_type min;
+		key_type max;
+	};
+
+	std::vector<block_bounds> bounds;
+	size_type indexed = 0U;
+	bool is_stale = false;
+
+	// bounds of rows [first, last), which is not empty
+	template <typename A>
+	[[nodiscard]]
+	static auto bounds_of(const A &array, const size_type first, const size_type last) -> block_bounds
+	{
+		const auto keys = impl::key_column<I>(array);
+		const auto [min, max] = std::minmax_element(keys + static_cast<std::ptrdiff_t>(first),
+		                                            keys + static_cast<std::ptrdiff_t>(last));
+		return {*min, *max};
+	}
+
+	// calls f(first, last) for the row range of every block overlapping [lo, hi]
+	template <typename F>
+	void for_each_block(const key_type &lo, const key_type &hi, F &&f) const
+	{
+		for (size_type block = 0U; block < std::size(bounds); ++block)
+			if (!(bounds[block].max < lo) && !(hi < bounds[block].min))
+				f(block * BlockRows, std::min(indexed, (block + 1U) * BlockRows));
+	}
+
+	template <typename A>
+	void check(const A &array) const
+	{
+		impl::check_index("soa::zone_map: index is out of date", !is_stale && indexed == std::size(array));
+	}
+};
+} // namespace soa
+
+#endif // SOA_COLUMN_INDEX_H
@@ -0,0 +1,342 @@
+#ifndef SOA_COLUMN_SHARED_H
+#define SOA_COLUMN_SHARED_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace soa
+{
+namespace impl
+{
+template <typename T, typename, typename Allocator>
+class column_shared;
+
+// one reference counted std::vector per field, shared by every copy of the storage until one of
+// them writes to it. A copy costs one reference count per column; the first write to a column
+// that is still shared copies that column alone, so a writer that changes a few columns of a
+// large array only pays for those. Const access never copies. A missing column is an empty one,
+// which is what a moved-from or cleared storage holds
+template <typename... Ts, std::size_t... Is, typename Allocator>
+class column_shared<std::tuple<Ts...>, std::index_sequence<Is...>, Allocator>
+{
+	using traits = std::allocator_traits<Allocator>;
+
+	template <typename U>
+	using vector = std::vector<U, typename traits::template rebind_alloc<U>>;
+
+	using columns_type = std::tuple<std::shared_ptr<vector<Ts>>...>;
+
+	template <std::size_t I>
+	using vector_t = std::tuple_element_t<I, std::tuple<vector<Ts>...>>;
+
+public:
+	using value_type = std::tuple<Ts...>;
+	using allocator_type = Allocator;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = std::tuple<Ts &...>;
+	using const_reference = std::tuple<const Ts &...>;
+	using pointer = std::tuple<Ts *...>;
+	using const_pointer = std::tuple<const Ts *...>;
+	using iterator = std::tuple<Ts *...>;
+	using const_iterator = std::tuple<const Ts *...>;
+	using reverse_iterator = std::tuple<std::reverse_iterator<Ts *>...>;
+	using const_reverse_iterator = std::tuple<std::reverse_iterator<const Ts *>...>;
+
+	column_shared() noexcept(noexcept(Allocator())) = default;
+
+	explicit column_shared(const Allocator &alloc) noexcept
+		: allocator{alloc}
+	{
+	}
+
+	column_shared(const column_shared &that)
+		: column_shared{that, traits::select_on_container_copy_construction(that.allocator)}
+	{
+	}
+
+	// shares the columns if alloc can free them, otherwise copies them into alloc
+	column_shared(const column_shared &that, const Allocator &alloc)
+		: allocator{alloc}
+	{
+		if (allocator == that.allocator)
+			columns = that.columns;
+		else
+			(..., (std::get<Is>(that.columns) != nullptr ? copy<Is>(std::get<Is>(that.columns)) : void()));
+	}
+
+	column_shared(column_shared &&that) noexcept
+		: allocator{std::move(that.allocator)}, columns{std::move(that.columns)}
+	{
+	}
+
+	column_shared(column_shared &&that, const Allocator &alloc)
+		: column_shared{std::as_const(that), alloc}
+	{
+		that.clear();
+	}
+
+	auto operator=(const column_shared &that) -> column_shared&
+	{
+		if (this != &that)
+		{
+			column_shared copy{that, propagate_on_copy ? that.allocator : allocator};
+			columns.swap(copy.columns);
+			if constexpr (propagate_on_copy)
+				std::swap(allocator, copy.allocator);
+		}
+		return *this;
+	}
+
+	auto operator=(column_shared &&that) noexcept(propagate_on_move || traits::is_always_equal::value) -> column_shared&
+	{
+		column_shared moved{std::move(that), propagate_on_move ? that.allocator : allocator};
+		columns.swap(moved.columns);
+		if constexpr (propagate_on_move)
+			std::swap(allocator, moved.allocator);
+		return *this;
+	}
+
+	[[nodiscard]]
+	auto get_allocator() const noexcept -> allocator_type
+	{
+		return allocator;
+	}
+
+	// a writable column, copied first if another storage still shares it
+	template <std::size_t I>
+	[[nodiscard]]
+	auto column() -> std::ranges::subrange<std::tuple_element_t<I, iterator>>
+	{
+		if (std::get<I>(columns) == nullptr)
+			return {};
+
+		auto &values = writable<I>();
+		return {std::data(values), std::data(values) + std::size(values)};
+	}
+
+	template <std::size_t I>
+	[[nodiscard]]
+	auto column() const noexcept -> std::ranges::subrange<std::tuple_element_t<I, const_iterator>>
+	{
+		if (const auto &values = std::get<I>(columns); values != nullptr)
+			return {std::data(*values), std::data(*values) + std::size(*values)};
+		return {};
+	}
+
+	// true while column I is also referenced by another storage
+	template <std::size_t I>
+	[[nodiscard]]
+	bool shared() const noexcept
+	{
+		return std::get<I>(columns).use_count() > 1;
+	}
+
+	[[nodiscard]]
+	bool empty() const noexcept
+	{
+		return size() == 0U;
+	}
+
+	[[nodiscard]]
+	auto size() const noexcept -> size_type
+	{
+		const auto &values = std::get<0>(columns);
+		return values != nullptr ? std::size(*values) : 0U;
+	}
+
+	[[nodiscard]]
+	auto max_size() const noexcept -> size_type
+	{
+		return std::min({vector<Ts>(typename vector<Ts>::allocator_type(allocator)).max_size()...});
+	}
+
+	[[nodiscard]]
+	auto capacity() const noexcept -> size_type
+	{
+		return std::min({(std::get<Is>(columns) != nullptr ? std::get<Is>(columns)->capacity() : 0U)...});
+	}
+
+	void reserve(const size_type new_cap)
+	{
+		if (new_cap > capacity())
+			(..., writable<Is>(new_cap).reserve(new_cap));
+	}
+
+	// a shared column already has no spare capacity
+	void shrink_to_fit()
+	{
+		(..., (owned<Is>() ? std::get<Is>(columns)->shrink_to_fit() : void()));
+	}
+
+	// releases shared columns instead of copying them just to empty them
+	void clear() noexcept
+	{
+		(..., (owned<Is>() ? std::get<Is>(columns)->clear() : std::get<Is>(columns).reset()));
+	}
+
+	template <typename U>
+	void insert(const size_type pos, U &&value)
+	{
+		const auto n = size() + 1U;
+		(..., writable<Is>(n).insert(std::begin(*std::get<Is>(columns)) + pos, std::get<Is>(std::forward<U>(value))));
+	}
+
+	void insert(const size_type pos, const size_type count, const value_type &value)
+	{
+		const auto n = size() + count;
+		(..., writable<Is>(n).insert(std::begin(*std::get<Is>(columns)) + pos, count, std::get<Is>(value)));
+	}
+
+	template <typename...Args>
+	void emplace(const size_type pos, Args &&...args)
+	{
+		const auto n = size() + 1U;
+		(..., std::apply(
+			[&](auto &&...xs)
+			{
+				writable<Is>(n).emplace(std::begin(*std::get<Is>(columns)) + pos, std::forward<decltype(xs)>(xs)...);
+			}, std::forward<Args>(args)));
+	}
+
+	void erase(const size_type first, const size_type last)
+	{
+		if (first == last)
+			return;
+
+		(..., writable<Is>().erase(std::begin(*std::get<Is>(columns)) + first, std::begin(*std::get<Is>(columns)) + last));
+	}
+
+	template <typename U>
+	void push_back(U &&value)
+	{
+		const auto n = size() + 1U;
+		(..., writable<Is>(n).push_back(std::get<Is>(std::forward<U>(value))));
+	}
+
+	template <typename...Args>
+	auto emplace_back(Args &&...args) -> reference
+	{
+		const auto n = size() + 1U;
+		return {
+			std::apply(
+				[&](auto &&...xs) -> auto&
+				{
+					return writable<Is>(n).emplace_back(std::forward<decltype(xs)>(xs)...);
+				}, std::forward<Args>(args))
+			...
+		};
+	}
+
+	// appends n elements to every column, column I copied from firsts[I]; on failure every column
+	// is cut back to its old size
+	template <typename... Its>
+	void append(const size_type n, Its... firsts)
+	{
+		const auto old_size = size();
+		(..., static_cast<void>(writable<Is>(old_size + n)));
+		try
+		{
+			(..., std::get<Is>(columns)->insert(std::end(*std::get<Is>(columns)), firsts, std::next(firsts, n)));
+		}
+		catch (...)
+		{
+			(..., std::get<Is>(columns)->erase(std::begin(*std::get<Is>(columns)) + old_size, std::end(*std::get<Is>(columns))));
+			throw;
+		}
+	}
+
+	void pop_back()
+	{
+		(..., writable<Is>().pop_back());
+	}
+
+	void resize(const size_type count)
+	{
+		(..., writable<Is>(count).resize(count));
+	}
+
+	void resize(const size_type count, const value_type &value)
+	{
+		(..., writable<Is>(count).resize(count, std::get<Is>(value)));
+	}
+
+	// like the standard containers, allocators that do not propagate on swap have to compare equal
+	void swap(column_shared &other) noexcept
+	{
+		if constexpr (traits::propagate_on_container_swap::value)
+			std::swap(allocator, other.allocator);
+		columns.swap(other.columns);
+	}
+
+private:
+	static constexpr bool propagate_on_copy = traits::propagate_on_container_copy_assignment::value;
+	static constexpr bool propagate_on_move = traits::propagate_on_container_move_assignment::value;
+
+	// what allocate_shared constructs; an allocator like polymorphic_allocator would otherwise
+	// pass itself to the vector a second time through uses-allocator construction
+	template <typename V>
+	struct holder
+	{
+		V values;
+
+		explicit holder(const typename V::allocator_type &alloc) noexcept
+			: values{alloc}
+		{
+		}
+	};
+
+	[[no_unique_address]] Allocator allocator{};
+	columns_type columns;
+
+	// column I created empty or copied from that, with room for capacity elements
+	template <std::size_t I>
+	void copy(const std::shared_ptr<vector_t<I>> &that, const size_type capacity = 0U)
+	{
+		using column_allocator = typename vector_t<I>::allocator_type;
+
+		auto block = std::allocate_shared<holder<vector_t<I>>>(allocator, column_allocator(allocator));
+		auto &values = block->values;
+		if (that != nullptr)
+		{
+			values.reserve(std::max(capacity, std::size(*that)));
+			values.insert(std::end(values), std::begin(*that), std::end(*that));
+		}
+		std::get<I>(columns) = std::shared_ptr<vector_t<I>>{std::move(block), &values};
+	}
+
+	// true if column I exists and no other storage refers to it
+	template <std::size_t I>
+	[[nodiscard]]
+	bool owned() const noexcept
+	{
+		if (std::get<I>(columns).use_count() != 1)
+			return false;
+
+		// another storage may just have released the column, its reads happen before our writes
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return true;
+	}
+
+	// column I owned by this storage alone, copied first (with room for capacity elements) while
+	// others share it
+	template <std::size_t I>
+	auto writable(const size_type capacity = 0U) -> vector_t<I>&
+	{
+		if (!owned<I>())
+			copy<I>(std::get<I>(columns), capacity);
+		return *std::get<I>(columns);
+	}
+};
+} // namespace impl
+} // namespace soa
+
+#endif // SOA_COLUMN_SHARED_H
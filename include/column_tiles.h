@@ -0,0 +1,201 @@
+#ifndef SOA_COLUMN_TILES_H
+#define SOA_COLUMN_TILES_H
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace soa
+{
+namespace impl
+{
+// iterator over one field of a tiled block: element i lives in tile i / Lanes at lane i % Lanes,
+// tiles are Stride bytes apart
+template <typename T, std::size_t Lanes, std::size_t Stride>
+class tile_iterator
+{
+	using byte_type = std::conditional_t<std::is_const_v<T>, const std::byte, std::byte>;
+
+public:
+	using iterator_concept = std::random_access_iterator_tag;
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = std::remove_cv_t<T>;
+	using difference_type = std::ptrdiff_t;
+	using reference = T&;
+	using pointer = T*;
+
+	tile_iterator() noexcept = default;
+
+	tile_iterator(byte_type *const base, const difference_type index) noexcept
+		: base{base}, index{index}
+	{
+	}
+
+	// conversion to const iterator
+	operator tile_iterator<const T, Lanes, Stride>() const noexcept
+	{
+		return {base, index};
+	}
+
+	auto operator*() const noexcept -> reference
+	{
+		return *operator->();
+	}
+
+	auto operator->() const noexcept -> pointer
+	{
+		const auto tile = static_cast<std::size_t>(index) / Lanes;
+		const auto lane = static_cast<std::size_t>(index) % Lanes;
+		return reinterpret_cast<pointer>(base + tile * Stride) + lane;
+	}
+
+	auto operator[](const difference_type n) const noexcept -> reference
+	{
+		return *(*this + n);
+	}
+
+	auto operator++() noexcept -> tile_iterator&
+	{
+		++index;
+		return *this;
+	}
+
+	auto operator++(int) noexcept -> tile_iterator
+	{
+		auto copy = *this;
+		++index;
+		return copy;
+	}
+
+	auto operator--() noexcept -> tile_iterator&
+	{
+		--index;
+		return *this;
+	}
+
+	auto operator--(int) noexcept -> tile_iterator
+	{
+		auto copy = *this;
+		--index;
+		return copy;
+	}
+
+	auto operator+=(const difference_type n) noexcept -> tile_iterator&
+	{
+		index += n;
+		return *this;
+	}
+
+	auto operator-=(const difference_type n) noexcept -> tile_iterator&
+	{
+		index -= n;
+		return *this;
+	}
+
+	[[nodiscard]]
+	friend auto operator+(tile_iterator it, const difference_type n) noexcept -> tile_iterator
+	{
+		return it += n;
+	}
+
+	[[nodiscard]]
+	friend auto operator+(const difference_type n, tile_iterator it) noexcept -> tile_iterator
+	{
+		return it += n;
+	}
+
+	[[nodiscard]]
+	friend auto operator-(tile_iterator it, const difference_type n) noexcept -> tile_iterator
+	{
+		return it -= n;
+	}
+
+	[[nodiscard]]
+	friend auto operator-(const tile_iterator &lhs, const tile_iterator &rhs) noexcept -> difference_type
+	{
+		return lhs.index - rhs.index;
+	}
+
+	[[nodiscard]]
+	friend bool operator==(const tile_iterator &lhs, const tile_iterator &rhs) noexcept
+	{
+		return lhs.index == rhs.index;
+	}
+
+	[[nodiscard]]
+	friend auto operator<=>(const tile_iterator &lhs, const tile_iterator &rhs) noexcept -> std::strong_ordering
+	{
+		return lhs.index <=> rhs.index;
+	}
+
+private:
+	byte_type *base = nullptr;
+	difference_type index = 0;
+};
+
+// array of structures of arrays: Lanes rows form a tile in which every field is stored as a
+// small contiguous array, tiles are laid out one after another
+template <std::size_t Lanes, std::size_t Alignment, typename... Ts>
+struct tile_addressing
+{
+	static_assert(Lanes > 0U, "a tile needs at least one lane");
+
+	static constexpr std::size_t alignment = std::max({Alignment, alignof(Ts)...});
+
+	static_assert((alignment & (alignment - 1U)) == 0U, "alignment has to be a power of two");
+
+private:
+	[[nodiscard]]
+	static constexpr auto round_up(const std::size_t bytes, const std::size_t to) noexcept -> std::size_t
+	{
+		return (bytes + to - 1U) / to * to;
+	}
+
+	// byte offset of every field inside a tile followed by the tile size
+	static constexpr auto layout = []
+	{
+		std::array<std::size_t, sizeof...(Ts) + 1U> result{};
+		std::size_t offset = 0U;
+		std::size_t i = 0U;
+		(..., (offset = round_up(offset, alignof(Ts)), result[i++] = offset, offset += Lanes * sizeof(Ts)));
+		result[i] = round_up(offset, std::max({alignof(Ts)...}));
+		return result;
+	}();
+
+public:
+	static constexpr std::size_t stride = layout.back();
+
+	using iterator = std::tuple<tile_iterator<Ts, Lanes, stride>...>;
+	using const_iterator = std::tuple<tile_iterator<const Ts, Lanes, stride>...>;
+
+	[[nodiscard]]
+	static constexpr auto capacity_for(const std::size_t count) noexcept -> std::size_t
+	{
+		return round_up(count, Lanes);
+	}
+
+	[[nodiscard]]
+	static constexpr auto bytes_for(const std::size_t capacity) noexcept -> std::size_t
+	{
+		return capacity / Lanes * stride;
+	}
+
+	[[nodiscard]]
+	static auto carve(std::byte *const block, const std::size_t) noexcept -> iterator
+	{
+		return [&]<std::size_t... Is>(std::index_sequence<Is...>)
+		{
+			return iterator{{block + layout[Is], 0}...};
+		}(std::index_sequence_for<Ts...>{});
+	}
+};
+} // namespace impl
+} // namespace soa
+
+#endif // SOA_COLUMN_TILES_H
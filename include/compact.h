@@ -0,0 +1,147 @@
+#ifndef SOA_COMPACT_H
+#define SOA_COMPACT_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include "bitmask.h"
+#include "simd.h"
+
+// Filtering driven by a bitmask: the predicate only reads the columns it names (simd::mask), then
+// every column is compacted or partitioned on its own in one pass, moving plain elements instead
+// of tuples of references. compact and partition with an explicit mask work on every layout,
+// erase_if and partition with a predicate need contiguous columns like the simd kernels.
+namespace soa
+{
+namespace impl
+{
+template <typename A>
+using column_indices_t = std::make_index_sequence<std::tuple_size_v<typename std::remove_cvref_t<A>::value_type>>;
+
+inline void check_mask(const std::size_t rows, const bitmask &mask)
+{
+	if (std::size(mask) != rows)
+		throw std::invalid_argument{"soa: bitmask size does not match the row count"};
+}
+
+// moves the elements whose bit is set to the front of column, keeping their order, and returns
+// their count; whole words of kept rows are moved as one range, the others jump from set bit to
+// set bit so cleared rows cost nothing. Rows that are already in place are not moved, a self move
+// leaves types like std::string in an unspecified state
+template <typename It>
+auto compact_column(const It column, const bitmask &keep) -> std::size_t
+{
+	using difference_type = std::iter_difference_t<It>;
+	const auto at = [&](const std::size_t i) { return column + static_cast<difference_type>(i); };
+
+	std::size_t out = 0U;
+	std::size_t base = 0U;
+	for (auto word : keep.words())
+	{
+		if (word == ~bitmask::word_type{0U})
+		{
+			if (out != base)
+				std::move(at(base), at(base + bitmask::word_bits), at(out));
+			out += bitmask::word_bits;
+		}
+		else
+		{
+			for (; word != 0U; word &= word - 1U, ++out)
+			{
+				const auto from = base + static_cast<std::size_t>(std::countr_zero(word));
+				if (from != out)
+					*at(out) = std::move(*at(from));
+			}
+		}
+		base += bitmask::word_bits;
+	}
+	return out;
+}
+
+// unstable partition of column into set bits followed by cleared bits, every column given the
+// same mask ends up with the same order
+template <typename It>
+void partition_column(const It column, const bitmask &selected)
+{
+	using difference_type = std::iter_difference_t<It>;
+
+	std::size_t first = 0U;
+	std::size_t last = std::size(selected);
+	for (;;)
+	{
+		while (first < last && selected[first])
+			++first;
+		while (first < last && !selected[last - 1U])
+			--last;
+		if (first >= last)
+			return;
+
+		--last;
+		std::iter_swap(column + static_cast<difference_type>(first), column + static_cast<difference_type>(last));
+		++first;
+	}
+}
+
+template <typename A, std::size_t... Is>
+auto compact(A &array, const bitmask &keep, std::index_sequence<Is...>) -> std::size_t
+{
+	check_mask(std::size(array), keep);
+
+	const auto columns = array.template project<Is...>().first;
+	std::size_t kept = 0U;
+	(..., (kept = compact_column(std::get<Is>(columns), keep)));
+	array.erase(std::begin(array) + static_cast<std::ptrdiff_t>(kept), std::end(array));
+	return kept;
+}
+
+template <typename A, std::size_t... Is>
+auto partition(A &array, const bitmask &selected, std::index_sequence<Is...>) -> std::size_t
+{
+	check_mask(std::size(array), selected);
+
+	const auto columns = array.template project<Is...>().first;
+	(..., partition_column(std::get<Is>(columns), selected));
+	return selected.count();
+}
+} // namespace impl
+
+// keeps the rows whose bit is set, in order, and returns how many are left
+template <typename A>
+auto compact(A &array, const bitmask &keep) -> std::size_t
+{
+	return impl::compact(array, keep, impl::column_indices_t<A>{});
+}
+
+// erases the rows for which pred(column In[i]...) holds and returns how many were erased, pred
+// follows the simd::mask conventions
+template <std::size_t... In, typename A, typename F>
+requires (sizeof...(In) > 0U)
+auto erase_if(A &array, F &&pred) -> std::size_t
+{
+	const auto n = std::size(array);
+	return n - compact(array, ~simd::mask<In...>(array, std::forward<F>(pred)));
+}
+
+// moves the rows whose bit is set in front of the others and returns their count, the relative
+// order within both groups is not kept
+template <typename A>
+auto partition(A &array, const bitmask &selected) -> std::size_t
+{
+	return impl::partition(array, selected, impl::column_indices_t<A>{});
+}
+
+// moves the rows for which pred(column In[i]...) holds in front of the others and returns their count
+template <std::size_t... In, typename A, typename F>
+requires (sizeof...(In) > 0U)
+auto partition(A &array, F &&pred) -> std::size_t
+{
+	return impl::partition(array, simd::mask<In...>(array, std::forward<F>(pred)), impl::column_indices_t<A>{});
+}
+} // namespace soa
+
+#endif // SOA_COMPACT_H
@@ -0,0 +1,731 @@
+#ifndef SOA_COMPRESSED_STRUCT_ARRAY_H
+#define SOA_COMPRESSED_STRUCT_ARRAY_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bitmask.h"
+#include "layout.h"
+#include "projection.h"
+#include "struct_array.h"
+#include "to_tuple.h"
+
+// Read-only columnar copy of a struct_array with per-column encodings for cold data. Columns are
+// cut into blocks of block_size rows and integral (and enum) columns encode every block on its own:
+// frame of reference (bit-packed offsets from the block minimum), delta (bit-packed differences to
+// the previous row plus the value of every 64th row for random access), dictionary (bit-packed
+// codes into a sorted column-wide dictionary) or run-length. Other columns are stored plain. Blocks
+// decode into contiguous buffers for the simd kernels, and mask / between evaluate predicates on
+// the encoded blocks: once per dictionary entry or run, and for ranges on the packed codes after
+// the block's min/max has ruled out or accepted the whole block.
+namespace soa
+{
+enum class encoding : std::uint8_t
+{
+	automatic,
+	plain,
+	frame_of_reference,
+	delta,
+	dictionary,
+	run_length
+};
+
+namespace impl
+{
+inline static constexpr std::size_t encoded_block_size = 1024U;
+
+// delta blocks keep the value of every row that is a multiple of this, so reading one row sums
+// fewer than this many differences
+inline static constexpr std::size_t delta_checkpoint_rows = 64U;
+
+// automatic encoding only builds dictionaries up to this many distinct values
+inline static constexpr std::size_t automatic_dictionary_limit = 65536U;
+
+template <typename U>
+concept encodable = std::is_integral_v<U> || std::is_enum_v<U>;
+
+template <typename U>
+struct underlying_integer
+{
+	using type = U;
+};
+
+template <typename U>
+requires std::is_enum_v<U>
+struct underlying_integer<U>
+{
+	using type = std::underlying_type_t<U>;
+};
+
+// values as 64 bit patterns whose wrapping differences are the value differences
+template <encodable U>
+[[nodiscard]]
+constexpr auto to_bits(const U value) noexcept -> std::uint64_t
+{
+	using I = typename underlying_integer<U>::type;
+	if constexpr (std::is_signed_v<I>)
+		return static_cast<std::uint64_t>(static_cast<std::int64_t>(static_cast<I>(value)));
+	else
+		return static_cast<std::uint64_t>(static_cast<I>(value));
+}
+
+template <encodable U>
+[[nodiscard]]
+constexpr auto from_bits(const std::uint64_t bits) noexcept -> U
+{
+	return static_cast<U>(static_cast<typename underlying_integer<U>::type>(bits));
+}
+
+[[nodiscard]]
+constexpr auto width_of(const std::uint64_t max_code) noexcept -> std::uint8_t
+{
+	return static_cast<std::uint8_t>(std::bit_width(max_code));
+}
+
+// codes of width bits are packed back to back, code i starts at bit i * width of its block
+[[nodiscard]]
+inline auto unpack(const std::uint64_t *const words, const std::size_t i, const unsigned width) noexcept
+	-> std::uint64_t
+{
+	if (width == 0U)
+		return 0U;
+
+	const auto bit = i * width;
+	const auto shift = bit % 64U;
+	auto value = words[bit / 64U] >> shift;
+	if (shift + width > 64U)
+		value |= words[bit / 64U + 1U] << (64U - shift);
+	return width == 64U ? value : value & ((std::uint64_t{1U} << width) - 1U);
+}
+
+inline void pack(std::vector<std::uint64_t> &words, const std::size_t first_word, const std::size_t i,
+                 const unsigned width, const std::uint64_t code)
+{
+	if (width == 0U)
+		return;
+
+	const auto bit = i * width;
+	const auto shift = bit % 64U;
+	const auto word = first_word + bit / 64U;
+	if (word + 1U >= std::size(words))
+		words.resize(word + 2U, 0U);
+
+	words[word] |= code << shift;
+	if (shift + width > 64U)
+		words[word + 1U] |= code >> (64U - shift);
+}
+
+// column of a type that cannot be encoded, blocks are slices of one vector
+template <typename U>
+class plain_column
+{
+public:
+	plain_column() = default;
+
+	template <typename It>
+	plain_column(It first, const std::size_t n, const encoding requested)
+		: values(first, first + static_cast<std::iter_difference_t<It>>(n))
+	{
+		if (requested != encoding::automatic && requested != encoding::plain)
+			throw std::invalid_argument{"soa::compressed_struct_array: only integral columns can be encoded"};
+	}
+
+	[[nodiscard]]
+	auto encoding_of(std::size_t) const noexcept -> encoding
+	{
+		return encoding::plain;
+	}
+
+	[[nodiscard]]
+	auto at(const std::size_t i) const -> U
+	{
+		return values[i];
+	}
+
+	[[nodiscard]]
+	auto block(const std::size_t k) const noexcept -> std::span<const U>
+	{
+		const auto first = k * encoded_block_size;
+		return {std::data(values) + first, std::min(encoded_block_size, std::size(values) - first)};
+	}
+
+	void decode(const std::size_t k, U *const out) const
+	{
+		std::ranges::copy(block(k), out);
+	}
+
+	template <typename F>
+	void mask(F &&pred, bitmask &result) const
+	{
+		for (std::size_t i = 0U; i < std::size(values); ++i)
+			if (pred(values[i]))
+				result.set(i);
+	}
+
+	template <typename V>
+	void between(const V &lo, const V &hi, bitmask &result) const
+	{
+		mask([&](const U &x) { return !(x < lo) && !(hi < x); }, result);
+	}
+
+	[[nodiscard]]
+	auto bytes() const noexcept -> std::size_t
+	{
+		return std::size(values) * sizeof(U);
+	}
+
+private:
+	std::vector<U> values;
+};
+
+// integral column, every block picks its own encoding
+template <encodable U>
+class encoded_column
+{
+	struct block_info
+	{
+		encoding kind;
+		std::uint8_t width;      // bits per code
+		std::uint32_t runs;      // run_length: number of runs
+		std::uint64_t base;      // frame_of_reference: minimum, delta: first value
+		std::uint64_t step;      // delta: smallest difference
+		std::size_t offset;      // first word, run or plain value of the block
+		std::size_t checkpoint;  // delta: first checkpoint of the block
+		U min;
+		U max;
+	};
+
+public:
+	encoded_column() = default;
+
+	template <typename It>
+	encoded_column(It first, const std::size_t n, const encoding requested)
+		: count{n}
+	{
+		// not a std::vector, which has no data() for bool
+		const auto values = std::make_unique_for_overwrite<U[]>(n);
+		std::copy_n(first, n, values.get());
+
+		if (requested == encoding::dictionary || requested == encoding::automatic)
+		{
+			dictionary.assign(values.get(), values.get() + n);
+			std::sort(std::begin(dictionary), std::end(dictionary));
+			dictionary.erase(std::unique(std::begin(dictionary), std::end(dictionary)), std::end(dictionary));
+			if (requested == encoding::automatic && std::size(dictionary) > automatic_dictionary_limit)
+				dictionary.clear();
+		}
+
+		for (std::size_t k = 0U; k * encoded_block_size < n; ++k)
+		{
+			const auto rows = std::min(encoded_block_size, n - k * encoded_block_size);
+			encode_block(std::span<const U>{values.get() + k * encoded_block_size, rows}, requested);
+		}
+
+		if (std::ranges::none_of(blocks, [](const block_info &b) { return b.kind == encoding::dictionary; }))
+			dictionary.clear();
+
+		dictionary.shrink_to_fit();
+		words.shrink_to_fit();
+		run_values.shrink_to_fit();
+		run_ends.shrink_to_fit();
+		plain.shrink_to_fit();
+		checkpoints.shrink_to_fit();
+	}
+
+	[[nodiscard]]
+	auto encoding_of(const std::size_t k) const noexcept -> encoding
+	{
+		return blocks[k].kind;
+	}
+
+	[[nodiscard]]
+	auto at(const std::size_t i) const -> U
+	{
+		const auto &b = blocks[i / encoded_block_size];
+		const auto j = i % encoded_block_size;
+		const auto *const codes = std::data(words) + b.offset;
+
+		switch (b.kind)
+		{
+		case encoding::frame_of_reference:
+			return from_bits<U>(b.base + unpack(codes, j, b.width));
+		case encoding::delta:
+		{
+			const auto c = j / delta_checkpoint_rows;
+			auto value = c == 0U ? b.base : checkpoints[b.checkpoint + c - 1U];
+			for (auto r = c * delta_checkpoint_rows; r < j; ++r)
+				value += b.step + unpack(codes, r, b.width);
+			return from_bits<U>(value);
+		}
+		case encoding::dictionary:
+			return dictionary[unpack(codes, j, b.width)];
+		case encoding::run_length:
+		{
+			const auto runs = std::span{std::data(run_ends) + b.offset, b.runs};
+			const auto run = std::ranges::upper_bound(runs, static_cast<std::uint32_t>(j)) - std::begin(runs);
+			return run_values[b.offset + static_cast<std::size_t>(run)];
+		}
+		default:
+			return plain[b.offset + j];
+		}
+	}
+
+	void decode(const std::size_t k, U *const out) const
+	{
+		const auto &b = blocks[k];
+		const auto rows = rows_of(k);
+		const auto *const codes = std::data(words) + b.offset;
+
+		switch (b.kind)
+		{
+		case encoding::frame_of_reference:
+			for (std::size_t j = 0U; j < rows; ++j)
+				out[j] = from_bits<U>(b.base + unpack(codes, j, b.width));
+			break;
+		case encoding::delta:
+		{
+			auto value = b.base;
+			out[0] = from_bits<U>(value);
+			for (std::size_t j = 1U; j < rows; ++j)
+				out[j] = from_bits<U>(value += b.step + unpack(codes, j - 1U, b.width));
+			break;
+		}
+		case encoding::dictionary:
+			for (std::size_t j = 0U; j < rows; ++j)
+				out[j] = dictionary[unpack(codes, j, b.width)];
+			break;
+		case encoding::run_length:
+		{
+			std::uint32_t begin = 0U;
+			for (std::uint32_t r = 0U; r < b.runs; ++r)
+			{
+				const auto end = run_ends[b.offset + r];
+				std::fill(out + begin, out + end, run_values[b.offset + r]);
+				begin = end;
+			}
+			break;
+		}
+		default:
+			std::copy_n(std::begin(plain) + static_cast<std::ptrdiff_t>(b.offset), rows, out);
+		}
+	}
+
+	// pred runs once per dictionary entry and once per run, otherwise on the decoded block
+	template <typename F>
+	void mask(F &&pred, bitmask &result) const
+	{
+		std::vector<bool> hits;
+		if (std::ranges::any_of(blocks, [](const block_info &b) { return b.kind == encoding::dictionary; }))
+		{
+			hits.reserve(std::size(dictionary));
+			for (const auto &value : dictionary)
+				hits.push_back(pred(value));
+		}
+
+		const auto buffer = std::make_unique_for_overwrite<U[]>(encoded_block_size);
+		for (std::size_t k = 0U; k < std::size(blocks); ++k)
+		{
+			const auto &b = blocks[k];
+			const auto first = k * encoded_block_size;
+			const auto rows = rows_of(k);
+
+			if (b.kind == encoding::dictionary)
+			{
+				const auto *const codes = std::data(words) + b.offset;
+				for (std::size_t j = 0U; j < rows; ++j)
+					if (hits[unpack(codes, j, b.width)])
+						result.set(first + j);
+			}
+			else if (b.kind == encoding::run_length)
+			{
+				for_each_run(b, [&](const std::size_t begin, const std::size_t end, const U &value)
+				{
+					if (pred(value))
+						result.set_range(first + begin, first + end);
+				});
+			}
+			else
+			{
+				decode(k, buffer.get());
+				for (std::size_t j = 0U; j < rows; ++j)
+					if (pred(buffer[j]))
+						result.set(first + j);
+			}
+		}
+	}
+
+	// lo <= x <= hi; blocks outside the range are skipped and blocks inside it filled using their
+	// min/max, frame of reference and dictionary blocks compare packed codes without decoding
+	void between(const U lo, const U hi, bitmask &result) const
+	{
+		const auto buffer = std::make_unique_for_overwrite<U[]>(encoded_block_size);
+		for (std::size_t k = 0U; k < std::size(blocks); ++k)
+		{
+			const auto &b = blocks[k];
+			const auto first = k * encoded_block_size;
+			const auto rows = rows_of(k);
+			const auto *const codes = std::data(words) + b.offset;
+
+			if (b.max < lo || hi < b.min)
+				continue;
+			if (!(b.min < lo) && !(hi < b.max))
+			{
+				result.set_range(first, first + rows);
+				continue;
+			}
+
+			switch (b.kind)
+			{
+			case encoding::frame_of_reference:
+			{
+				const auto low = lo < b.min ? std::uint64_t{0U} : to_bits(lo) - b.base;
+				const auto high = to_bits(std::min(hi, b.max)) - b.base;
+				for (std::size_t j = 0U; j < rows; ++j)
+					if (const auto code = unpack(codes, j, b.width); low <= code && code <= high)
+						result.set(first + j);
+				break;
+			}
+			case encoding::dictionary:
+			{
+				const auto low = static_cast<std::uint64_t>(std::ranges::lower_bound(dictionary, lo) - std::begin(dictionary));
+				const auto high = static_cast<std::uint64_t>(std::ranges::upper_bound(dictionary, hi) - std::begin(dictionary));
+				for (std::size_t j = 0U; j < rows; ++j)
+					if (const auto code = unpack(codes, j, b.width); low <= code && code < high)
+						result.set(first + j);
+				break;
+			}
+			case encoding::run_length:
+				for_each_run(b, [&](const std::size_t begin, const std::size_t end, const U &value)
+				{
+					if (!(value < lo) && !(hi < value))
+						result.set_range(first + begin, first + end);
+				});
+				break;
+			default:
+				decode(k, buffer.get());
+				for (std::size_t j = 0U; j < rows; ++j)
+					if (!(buffer[j] < lo) && !(hi < buffer[j]))
+						result.set(first + j);
+			}
+		}
+	}
+
+	[[nodiscard]]
+	auto bytes() const noexcept -> std::size_t
+	{
+		return std::size(blocks) * sizeof(block_info) + std::size(words) * sizeof(std::uint64_t)
+			+ std::size(dictionary) * sizeof(U) + std::size(run_values) * sizeof(U)
+			+ std::size(run_ends) * sizeof(std::uint32_t) + std::size(plain) * sizeof(U)
+			+ std::size(checkpoints) * sizeof(std::uint64_t);
+	}
+
+private:
+	std::size_t count = 0U;
+	std::vector<block_info> blocks;
+	std::vector<std::uint64_t> words;
+	std::vector<U> dictionary;
+	std::vector<U> run_values;
+	std::vector<std::uint32_t> run_ends; // end of every run relative to its block
+	std::vector<U> plain;
+	std::vector<std::uint64_t> checkpoints; // delta: value of rows 64, 128, ... of every block
+
+	[[nodiscard]]
+	auto rows_of(const std::size_t k) const noexcept -> std::size_t
+	{
+		return std::min(encoded_block_size, count - k * encoded_block_size);
+	}
+
+	template <typename F>
+	void for_each_run(const block_info &b, F &&f) const
+	{
+		std::size_t begin = 0U;
+		for (std::uint32_t r = 0U; r < b.runs; ++r)
+		{
+			const std::size_t end = run_ends[b.offset + r];
+			f(begin, end, run_values[b.offset + r]);
+			begin = end;
+		}
+	}
+
+	void encode_block(const std::span<const U> values, const encoding requested)
+	{
+		const auto [min, max] = std::ranges::minmax(values);
+		const auto rows = std::size(values);
+
+		auto step = std::uint64_t{0U};
+		auto max_delta = std::uint64_t{0U};
+		if (rows > 1U)
+		{
+			auto smallest = std::numeric_limits<std::int64_t>::max();
+			auto largest = std::numeric_limits<std::int64_t>::min();
+			for (std::size_t j = 1U; j < rows; ++j)
+			{
+				const auto d = static_cast<std::int64_t>(to_bits(values[j]) - to_bits(values[j - 1U]));
+				smallest = std::min(smallest, d);
+				largest = std::max(largest, d);
+			}
+			step = static_cast<std::uint64_t>(smallest);
+			max_delta = static_cast<std::uint64_t>(largest) - step;
+		}
+
+		std::uint32_t runs = 1U;
+		for (std::size_t j = 1U; j < rows; ++j)
+			runs += values[j] != values[j - 1U] ? 1U : 0U;
+
+		const auto range_width = width_of(to_bits(max) - to_bits(min));
+		const auto delta_width = width_of(max_delta);
+		const auto code_width = std::empty(dictionary) ? std::uint8_t{0U} : width_of(std::size(dictionary) - 1U);
+
+		auto kind = requested;
+		if (kind == encoding::automatic)
+		{
+			// sizes in bits, the first smallest wins
+			const std::array<std::pair<encoding, std::size_t>, 5U> candidates{{
+				{encoding::frame_of_reference, rows * range_width},
+				{encoding::dictionary, std::empty(dictionary) ? static_cast<std::size_t>(-1) : rows * code_width},
+				{encoding::run_length, runs * (sizeof(U) + sizeof(std::uint32_t)) * 8U},
+				{encoding::delta, (rows - 1U) * delta_width + (1U + (rows - 1U) / delta_checkpoint_rows) * 64U},
+				{encoding::plain, rows * sizeof(U) * 8U}
+			}};
+			kind = std::ranges::min(candidates, {}, &std::pair<encoding, std::size_t>::second).first;
+		}
+
+		block_info b{kind, 0U, 0U, 0U, 0U, 0U, 0U, min, max};
+		switch (kind)
+		{
+		case encoding::frame_of_reference:
+			b.width = range_width;
+			b.base = to_bits(min);
+			b.offset = add_codes(rows, b.width, [&](const std::size_t j) { return to_bits(values[j]) - b.base; });
+			break;
+		case encoding::delta:
+			b.width = delta_width;
+			b.base = to_bits(values[0]);
+			b.step = step;
+			b.offset = add_codes(rows - 1U, b.width, [&](const std::size_t j)
+			{
+				return to_bits(values[j + 1U]) - to_bits(values[j]) - step;
+			});
+			b.checkpoint = std::size(checkpoints);
+			for (auto j = delta_checkpoint_rows; j < rows; j += delta_checkpoint_rows)
+				checkpoints.push_back(to_bits(values[j]));
+			break;
+		case encoding::dictionary:
+			b.width = code_width;
+			b.offset = add_codes(rows, b.width, [&](const std::size_t j)
+			{
+				return static_cast<std::uint64_t>(std::ranges::lower_bound(dictionary, values[j]) - std::begin(dictionary));
+			});
+			break;
+		case encoding::run_length:
+			b.runs = runs;
+			b.offset = std::size(run_values);
+			for (std::size_t j = 1U; j <= rows; ++j)
+			{
+				if (j == rows || values[j] != values[j - 1U])
+				{
+					run_values.push_back(values[j - 1U]);
+					run_ends.push_back(static_cast<std::uint32_t>(j));
+				}
+			}
+			break;
+		default:
+			b.kind = encoding::plain;
+			b.offset = std::size(plain);
+			plain.insert(std::end(plain), std::begin(values), std::end(values));
+		}
+		blocks.push_back(b);
+	}
+
+	// packs n codes starting on a fresh word and returns that word
+	template <typename F>
+	auto add_codes(const std::size_t n, const unsigned width, F &&code) -> std::size_t
+	{
+		const auto first = std::size(words);
+		words.resize(first + (n * width + 63U) / 64U, 0U);
+		for (std::size_t j = 0U; j < n; ++j)
+			pack(words, first, j, width, code(j));
+		words.resize(first + (n * width + 63U) / 64U);
+		return first;
+	}
+};
+
+template <typename U>
+struct column_codec
+{
+	using type = plain_column<U>;
+};
+
+template <encodable U>
+struct column_codec<U>
+{
+	using type = encoded_column<U>;
+};
+
+template <typename U>
+using column_codec_t = typename column_codec<U>::type;
+} // namespace impl
+
+// read-only, block-encoded copy of the rows of a struct_array or struct_array_view
+template <typename T>
+class compressed_struct_array
+{
+	using columns_type = to_tuple_t<T>;
+	using indices = std::make_index_sequence<std::tuple_size_v<columns_type>>;
+
+	template <std::size_t I>
+	using column_t = std::tuple_element_t<I, columns_type>;
+
+	template <std::size_t... Is>
+	static auto codecs_for(std::index_sequence<Is...>) -> std::tuple<impl::column_codec_t<column_t<Is>>...>;
+
+public:
+	using struct_type = T;
+	using value_type = columns_type;
+	using size_type = std::size_t;
+
+	static constexpr std::size_t block_size = impl::encoded_block_size;
+
+	compressed_struct_array() = default;
+
+	// encodings[I] is used for column I, automatic picks the smallest encoding per block
+	template <typename A>
+	requires std::is_same_v<T, typename std::remove_cvref_t<A>::struct_type>
+	explicit compressed_struct_array(const A &array, const std::array<encoding, std::tuple_size_v<columns_type>> &encodings = {})
+		: compressed_struct_array{array, encodings, indices{}}
+	{
+	}
+
+	[[nodiscard]]
+	bool empty() const noexcept
+	{
+		return count == 0U;
+	}
+
+	[[nodiscard]]
+	auto size() const noexcept -> size_type
+	{
+		return count;
+	}
+
+	[[nodiscard]]
+	auto block_count() const noexcept -> size_type
+	{
+		return (count + block_size - 1U) / block_size;
+	}
+
+	// rows in block k
+	[[nodiscard]]
+	auto block_rows(const size_type k) const noexcept -> size_type
+	{
+		return std::min(block_size, count - k * block_size);
+	}
+
+	// encoded size of all columns
+	[[nodiscard]]
+	auto bytes() const noexcept -> size_type
+	{
+		return std::apply([](const auto &...columns) { return (size_type{0U} + ... + columns.bytes()); }, codecs);
+	}
+
+	// decodes row pos
+	[[nodiscard]]
+	auto operator[](const size_type pos) const -> value_type
+	{
+		return std::apply([&](const auto &...columns) { return value_type{columns.at(pos)...}; }, codecs);
+	}
+
+	template <std::size_t I>
+	[[nodiscard]]
+	auto encoding_of(const size_type k) const noexcept -> encoding
+	{
+		return std::get<I>(codecs).encoding_of(k);
+	}
+
+	// decodes column I of block k into out, which holds at least block_rows(k) elements
+	template <std::size_t I>
+	auto decode(const size_type k, const std::span<column_t<I>> out) const -> size_type
+	{
+		std::get<I>(codecs).decode(k, std::data(out));
+		return block_rows(k);
+	}
+
+	// decodes columns Is... block by block into reused buffers and calls f with a projection of
+	// them, so every simd kernel can run on the block
+	template <std::size_t... Is, typename F>
+	void for_each_block(F &&f) const
+	{
+		const std::tuple buffers{std::make_unique_for_overwrite<column_t<Is>[]>(block_size)...};
+		[&]<std::size_t... Ks>(std::index_sequence<Ks...>)
+		{
+			for (size_type k = 0U; k < block_count(); ++k)
+			{
+				(..., std::get<Is>(codecs).decode(k, std::get<Ks>(buffers).get()));
+				f(impl::projection<std::tuple<const column_t<Is> *...>>{{std::get<Ks>(buffers).get()...}, block_rows(k)});
+			}
+		}(std::index_sequence_for<column_t<Is>...>{});
+	}
+
+	// bit i is set if pred(column I[i]) holds
+	template <std::size_t I, typename F>
+	[[nodiscard]]
+	auto mask(F &&pred) const -> bitmask
+	{
+		bitmask result{count};
+		std::get<I>(codecs).mask(pred, result);
+		return result;
+	}
+
+	// bit i is set if lo <= column I[i] <= hi
+	template <std::size_t I>
+	[[nodiscard]]
+	auto between(const column_t<I> &lo, const column_t<I> &hi) const -> bitmask
+	{
+		bitmask result{count};
+		std::get<I>(codecs).between(lo, hi, result);
+		return result;
+	}
+
+	// decodes everything into a struct_array
+	template <typename Layout = layout::vectors, typename Allocator = std::allocator<std::byte>>
+	[[nodiscard]]
+	auto to_struct_array(const Allocator &alloc = Allocator()) const -> struct_array<T, Layout, Allocator>
+	{
+		struct_array<T, Layout, Allocator> result{alloc};
+		result.reserve(count);
+		[&]<std::size_t... Is>(std::index_sequence<Is...>)
+		{
+			for_each_block<Is...>([&](const auto &block)
+			{
+				result.append_columns(std::span{std::get<Is>(block.data()), std::size(block)}...);
+			});
+		}(indices{});
+		return result;
+	}
+
+private:
+	template <typename A, std::size_t... Is>
+	compressed_struct_array(const A &array, const std::array<encoding, sizeof...(Is)> &encodings, std::index_sequence<Is...>)
+		: count{std::size(array)},
+		  codecs{impl::column_codec_t<column_t<Is>>{std::get<Is>(array.template project<Is...>().first), count, encodings[Is]}...}
+	{
+	}
+
+	size_type count = 0U;
+	decltype(codecs_for(indices{})) codecs;
+};
+} // namespace soa
+
+#endif // SOA_COMPRESSED_STRUCT_ARRAY_H
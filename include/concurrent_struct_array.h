@@ -0,0 +1,261 @@
+#ifndef SOA_CONCURRENT_STRUCT_ARRAY_H
+#define SOA_CONCURRENT_STRUCT_ARRAY_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "column_block.h"
+#include "column_tiles.h"
+#include "layout.h"
+#include "struct_array.h"
+#include "struct_array_view.h"
+#include "to_tuple.h"
+
+// Multi-producer append front end. Producers claim row slots with a compare_exchange on a shared
+// counter, construct their rows in chunks that were allocated up front, and then publish them by
+// advancing a commit watermark in claim order, waiting for earlier claims to publish first.
+// Readers see the committed prefix only: size() is the watermark and every row below it is fully
+// constructed. Nothing may throw between claiming and publishing, so rows are built before the
+// claim and moved into place, which requires nothrow move constructible fields (bulk appends copy
+// straight into place when the fields are nothrow copy constructible).
+namespace soa
+{
+namespace impl
+{
+template <typename T, std::size_t ChunkSize, typename, typename, typename Allocator>
+class concurrent_struct_array_impl;
+
+template <typename T, std::size_t ChunkSize, typename... Ts, std::size_t... Is, typename Allocator>
+class concurrent_struct_array_impl<T, ChunkSize, std::tuple<Ts...>, std::index_sequence<Is...>, Allocator>
+{
+	static_assert((... && std::is_nothrow_move_constructible_v<Ts>),
+	              "concurrent_struct_array needs nothrow move constructible fields");
+
+	// a chunk is a single tile of ChunkSize rows, every column contiguous inside it
+	using addressing = tile_addressing<ChunkSize, cache_line_size, Ts...>;
+	using chunk = aligned_chunk<addressing::alignment>;
+	using chunk_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<chunk>;
+	using chunk_traits = std::allocator_traits<chunk_allocator>;
+	using directory_type = std::vector<std::byte *, typename std::allocator_traits<Allocator>::template rebind_alloc<std::byte *>>;
+
+	static constexpr std::size_t chunk_units = (addressing::bytes_for(ChunkSize) + sizeof(chunk) - 1U) / sizeof(chunk);
+
+public:
+	using struct_type = T;
+	using value_type = std::tuple<Ts...>;
+	using allocator_type = Allocator;
+	using size_type = std::size_t;
+	using const_reference = std::tuple<const Ts &...>;
+
+	static constexpr std::size_t chunk_size = ChunkSize;
+
+	// allocates room for at least capacity rows, producers can never go past it
+	explicit concurrent_struct_array_impl(const size_type capacity, const Allocator &alloc = Allocator())
+		: allocator{alloc}, directory(alloc)
+	{
+		reserve(capacity);
+	}
+
+	concurrent_struct_array_impl(const concurrent_struct_array_impl &) = delete;
+
+	~concurrent_struct_array_impl()
+	{
+		clear();
+		for (auto *const block : directory)
+			chunk_traits::deallocate(allocator, reinterpret_cast<chunk *>(block), chunk_units);
+	}
+
+	auto operator=(const concurrent_struct_array_impl &) -> concurrent_struct_array_impl& = delete;
+
+	[[nodiscard]]
+	auto get_allocator() const noexcept -> allocator_type
+	{
+		return allocator_type(allocator);
+	}
+
+	// appends one row and returns its index once it is committed, safe to call concurrently
+	template <typename U>
+	requires std::is_same_v<T, std::decay_t<U>>
+	auto push_back(U &&value) -> size_type
+	{
+		return publish(make_to_tuple<T>(std::forward<U>(value)));
+	}
+
+	// one tuple of constructor arguments per field, like struct_array::emplace_back
+	template <typename...Args>
+	requires (sizeof...(Args) == sizeof...(Ts))
+	auto emplace_back(Args &&...args) -> size_type
+	{
+		return publish(value_type{std::make_from_tuple<Ts>(std::forward<Args>(args))...});
+	}
+
+	// appends the T objects [first, last) as consecutive rows with a single claim and returns the
+	// index of the first one, safe to call concurrently; fields that may throw on copy are copied
+	// into a buffer before claiming
+	template <std::forward_iterator It>
+	requires std::is_same_v<T, std::remove_cvref_t<std::iter_reference_t<It>>>
+	auto append(It first, const It last) -> size_type
+	{
+		const auto n = static_cast<size_type>(std::distance(first, last));
+		if constexpr (!(... && std::is_nothrow_copy_constructible_v<Ts>))
+		{
+			std::vector<value_type> rows;
+			rows.reserve(n);
+			for (; first != last; ++first)
+				rows.push_back(make_to_tuple<T>(static_cast<const T &>(*first)));
+
+			const auto index = claim(n);
+			for (size_type i = 0U; i < n; ++i)
+				(..., std::construct_at(slot<Is>(index + i), std::move(std::get<Is>(rows[i]))));
+			commit(index, n);
+			return index;
+		}
+		else
+		{
+			const auto index = claim(n);
+			for (auto i = index; i < index + n; ++i, ++first)
+			{
+				const auto fields = make_tie<T>(*first);
+				(..., std::construct_at(slot<Is>(i), std::get<Is>(fields)));
+			}
+			commit(index, n);
+			return index;
+		}
+	}
+
+	// rows that are committed, i.e. safe to read
+	[[nodiscard]]
+	auto size() const noexcept -> size_type
+	{
+		return committed.load(std::memory_order_acquire);
+	}
+
+	[[nodiscard]]
+	bool empty() const noexcept
+	{
+		return size() == 0U;
+	}
+
+	[[nodiscard]]
+	auto capacity() const noexcept -> size_type
+	{
+		return std::size(directory) * ChunkSize;
+	}
+
+	// pos has to be below a size() this thread has observed
+	[[nodiscard]]
+	auto operator[](const size_type pos) const noexcept -> const_reference
+	{
+		return {*slot<Is>(pos)...};
+	}
+
+	// calls f with a struct_array_view<const T> per chunk of the committed prefix
+	template <typename F>
+	void for_each_segment(F &&f) const
+	{
+		const auto n = size();
+		for (size_type k = 0U; k * ChunkSize < n; ++k)
+		{
+			f(struct_array_view<const T>{
+				std::tuple<const Ts *...>{slot<Is>(k * ChunkSize)...}, std::min(ChunkSize, n - k * ChunkSize)
+			});
+		}
+	}
+
+	// adds chunks until capacity rows fit, not safe while producers are running
+	void reserve(const size_type capacity)
+	{
+		directory.reserve((capacity + ChunkSize - 1U) / ChunkSize);
+		while (this->capacity() < capacity)
+			directory.push_back(reinterpret_cast<std::byte *>(
+				std::to_address(chunk_traits::allocate(allocator, chunk_units))));
+	}
+
+	// moves the committed rows into a struct_array and empties this one, keeping its chunks;
+	// not safe while producers are running
+	template <typename Layout = layout::vectors, typename Alloc = Allocator>
+	[[nodiscard]]
+	auto seal(const Alloc &alloc = Alloc()) -> struct_array<T, Layout, Alloc>
+	{
+		struct_array<T, Layout, Alloc> result{alloc};
+		const auto n = size();
+		result.reserve(n);
+		for (size_type first = 0U; first < n; first += ChunkSize)
+			result.components.append(std::min(ChunkSize, n - first), std::make_move_iterator(slot<Is>(first))...);
+		clear();
+		return result;
+	}
+
+	// destroys every row, not safe while producers are running
+	void clear() noexcept
+	{
+		const auto n = size();
+		for (size_type i = 0U; i < n; ++i)
+			(..., std::destroy_at(slot<Is>(i)));
+		claimed.store(0U, std::memory_order_relaxed);
+		committed.store(0U, std::memory_order_release);
+	}
+
+private:
+	[[no_unique_address]] chunk_allocator allocator{};
+	directory_type directory;
+	alignas(cache_line_size) std::atomic<size_type> claimed{0U};
+	alignas(cache_line_size) std::atomic<size_type> committed{0U};
+
+	template <std::size_t I>
+	[[nodiscard]]
+	auto slot(const size_type i) const noexcept -> std::tuple_element_t<I, std::tuple<Ts...>>*
+	{
+		return std::addressof(*(std::get<I>(addressing::carve(directory[i / ChunkSize], ChunkSize))
+			+ static_cast<std::ptrdiff_t>(i % ChunkSize)));
+	}
+
+	// reserves n consecutive rows; a claim that does not fit leaves the counter alone, so the
+	// watermark can still reach every successful claim and reserve makes room for later ones
+	auto claim(const size_type n) -> size_type
+	{
+		auto index = claimed.load(std::memory_order_relaxed);
+		do
+		{
+			if (n > capacity() - index)
+				throw std::length_error{"soa::concurrent_struct_array: capacity exhausted"};
+		}
+		while (!claimed.compare_exchange_weak(index, index + n, std::memory_order_relaxed));
+		return index;
+	}
+
+	// makes rows [index, index + n) visible after every earlier claim has been
+	void commit(const size_type index, const size_type n) noexcept
+	{
+		for (auto current = committed.load(std::memory_order_acquire); current != index;
+		     current = committed.load(std::memory_order_acquire))
+			committed.wait(current, std::memory_order_acquire);
+
+		committed.store(index + n, std::memory_order_release);
+		committed.notify_all();
+	}
+
+	auto publish(value_type &&row) -> size_type
+	{
+		const auto index = claim(1U);
+		(..., std::construct_at(slot<Is>(index), std::move(std::get<Is>(row))));
+		commit(index, 1U);
+		return index;
+	}
+};
+} // namespace impl
+
+template <typename T, std::size_t ChunkSize = 4096U, typename Allocator = std::allocator<std::byte>>
+using concurrent_struct_array = impl::concurrent_struct_array_impl<
+	T, ChunkSize, to_tuple_t<T>, std::make_index_sequence<std::tuple_size_v<to_tuple_t<T>>>, Allocator>;
+} // namespace soa
+
+#endif // SOA_CONCURRENT_STRUCT_ARRAY_H
@@ -0,0 +1,73 @@
+#ifndef SOA_DESCRIBE_H
+#define SOA_DESCRIBE_H
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+
+#include <boost/preprocessor.hpp>
+
+// Opt-in field lists. SOA_FIELDS(T, a, b, c) at namespace scope (in T's namespace) declares the
+// data members a, b and c of T as its columns, in that order:
+//
+//   struct particle { float x, y, z; std::uint32_t id; };
+//   SOA_FIELDS(particle, x, y, z, id)
+//
+// A described type skips the brace-initialization arity probe and the structured bindings of
+// to_tuple.h, so it is not limited by SOA_MAX_BINDINGS, and it gets field names and exact offsets.
+// The macro expands to a constexpr soa_describe(soa::describe_tag<T>) function that is found by
+// argument dependent lookup; templates can write that function by hand.
+namespace soa
+{
+template <typename T>
+struct describe_tag
+{
+};
+
+namespace impl
+{
+template <typename Members, std::size_t N>
+struct description
+{
+	Members members;
+	std::array<std::string_view, N> names;
+	std::array<std::size_t, N> offsets;
+};
+
+template <typename... Ms>
+constexpr auto make_description(const std::tuple<Ms...> members,
+                                const std::array<std::string_view, sizeof...(Ms)> names,
+                                const std::array<std::size_t, sizeof...(Ms)> offsets) noexcept
+	-> description<std::tuple<Ms...>, sizeof...(Ms)>
+{
+	return {members, names, offsets};
+}
+} // namespace impl
+
+template <typename T>
+concept described = requires { soa_describe(describe_tag<T>{}); };
+
+namespace impl
+{
+// the description of T, only usable in constant expressions
+template <typename T>
+requires described<T>
+inline static constexpr auto description_v = soa_describe(describe_tag<T>{});
+} // namespace impl
+} // namespace soa
+
+#define SOA_FIELDS_MEMBER(r, T, i, member) BOOST_PP_COMMA_IF(i) &T::member
+#define SOA_FIELDS_NAME(r, T, i, member) BOOST_PP_COMMA_IF(i) std::string_view{BOOST_PP_STRINGIZE(member)}
+#define SOA_FIELDS_OFFSET(r, T, i, member) BOOST_PP_COMMA_IF(i) offsetof(T, member)
+#define SOA_FIELDS_EACH(macro, T, ...) BOOST_PP_SEQ_FOR_EACH_I(macro, T, BOOST_PP_VARIADIC_TO_SEQ(__VA_ARGS__))
+
+#define SOA_FIELDS(T, ...)                                                    \
+  [[nodiscard]] constexpr auto soa_describe(::soa::describe_tag<T>) noexcept {  \
+    return ::soa::impl::make_description(                                     \
+        std::tuple{SOA_FIELDS_EACH(SOA_FIELDS_MEMBER, T, __VA_ARGS__)},       \
+        {SOA_FIELDS_EACH(SOA_FIELDS_NAME, T, __VA_ARGS__)},                   \
+        {SOA_FIELDS_EACH(SOA_FIELDS_OFFSET, T, __VA_ARGS__)});                \
+  }
+
+#endif // SOA_DESCRIBE_H
@@ -0,0 +1,123 @@
+#ifndef SOA_FIELDS_H
+#define SOA_FIELDS_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "describe.h"
+#include "to_tuple.h"
+
+// Compile-time field metadata: soa::fields<T> has the count, names, offsets, sizes and alignments of
+// the columns of T, and soa::get<"name">(object) reaches a member by name. Names and exact offsets
+// come from SOA_FIELDS; for other types the names are empty and the offsets are laid out the way a
+// standard layout class places its members.
+namespace soa
+{
+// string literal usable as a template argument, e.g. get<"x">
+template <std::size_t N>
+struct fixed_string
+{
+	char value[N]{};
+
+	constexpr fixed_string(const char (&string)[N]) noexcept
+	{
+		std::copy_n(string, N, value);
+	}
+
+	[[nodiscard]]
+	constexpr auto view() const noexcept -> std::string_view
+	{
+		return {value, N - 1U};
+	}
+};
+
+namespace impl
+{
+template <typename T, typename>
+struct fields_impl;
+
+template <typename T, typename... Ts>
+struct fields_impl<T, std::tuple<Ts...>>
+{
+	using types = std::tuple<Ts...>;
+
+	static constexpr std::size_t count = sizeof...(Ts);
+
+	static constexpr std::array<std::size_t, count> sizes{sizeof(Ts)...};
+	static constexpr std::array<std::size_t, count> alignments{alignof(Ts)...};
+
+	static constexpr std::array<std::string_view, count> names = []
+	{
+		if constexpr (described<T>)
+			return description_v<T>.names;
+		else
+			return std::array<std::string_view, count>{};
+	}();
+
+	static constexpr std::array<std::size_t, count> offsets = []
+	{
+		if constexpr (described<T>)
+			return description_v<T>.offsets;
+		else
+		{
+			static_assert(std::is_standard_layout_v<T>, "offsets of undescribed types need a standard layout");
+
+			std::array<std::size_t, count> result{};
+			std::size_t end = 0U;
+			for (std::size_t i = 0U; i < count; ++i)
+			{
+				result[i] = (end + alignments[i] - 1U) / alignments[i] * alignments[i];
+				end = result[i] + sizes[i];
+			}
+			return result;
+		}
+	}();
+
+	// position of the field called name, count if there is none
+	[[nodiscard]]
+	static constexpr auto index_of(const std::string_view name) noexcept -> std::size_t
+	{
+		return static_cast<std::size_t>(std::find(std::begin(names), std::end(names), name) - std::begin(names));
+	}
+};
+} // namespace impl
+
+template <typename T>
+struct fields : impl::fields_impl<T, to_tuple_t<T>>
+{
+	template <std::size_t I>
+	using type = std::tuple_element_t<I, to_tuple_t<T>>;
+};
+
+// position of the field called Name among the columns of a described T
+template <typename T, fixed_string Name>
+struct field_index : std::integral_constant<std::size_t, fields<T>::index_of(Name.view())>
+{
+	static_assert(described<T>, "field names need SOA_FIELDS");
+	static_assert(field_index::value < fields<T>::count, "no field with this name");
+};
+
+template <typename T, fixed_string Name>
+inline static constexpr auto field_index_v = field_index<T, Name>::value;
+
+template <fixed_string Name, described T>
+[[nodiscard]]
+constexpr auto get(T &object) noexcept -> auto&
+{
+	return object.*std::get<field_index_v<T, Name>>(impl::description_v<T>.members);
+}
+
+template <fixed_string Name, described T>
+[[nodiscard]]
+constexpr auto get(const T &object) noexcept -> const auto&
+{
+	return object.*std::get<field_index_v<T, Name>>(impl::description_v<T>.members);
+}
+} // namespace soa
+
+#endif // SOA_FIELDS_H
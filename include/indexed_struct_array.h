@@ -0,0 +1,225 @@
+#ifndef SOA_INDEXED_STRUCT_ARRAY_H
+#define SOA_INDEXED_STRUCT_ARRAY_H
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "column_index.h"
+#include "struct_array.h"
+
+namespace soa
+{
+// struct_array that keeps a set of column indexes (column_index.h) in step with its rows, e.g.
+//
+//   soa::indexed_struct_array<particle, std::tuple<soa::hash_index<particle, 3>, soa::zone_map<particle, 0>>> p;
+//   const auto rows = p.find<0>(42U);
+//
+// Every mutation goes through this class so the indexes hear about it: appends are indexed as
+// they happen where the index allows it, other changes mark an index stale and it is rebuilt on
+// the next lookup through index<N>() or find<N>(). Rows are only readable from outside, in-place
+// changes go through modify
+template <typename T, typename Indexes, typename Layout = layout::vectors, typename Allocator = std::allocator<std::byte>>
+class indexed_struct_array;
+
+template <typename T, typename... Indexes, typename Layout, typename Allocator>
+class indexed_struct_array<T, std::tuple<Indexes...>, Layout, Allocator>
+{
+public:
+	using array_type = struct_array<T, Layout, Allocator>;
+	using index_types = std::tuple<Indexes...>;
+	using allocator_type = Allocator;
+	using value_type = typename array_type::value_type;
+	using size_type = typename array_type::size_type;
+	using difference_type = typename array_type::difference_type;
+	using reference = typename array_type::reference;
+	using const_reference = typename array_type::const_reference;
+	using const_iterator = typename array_type::const_iterator;
+
+	indexed_struct_array() = default;
+
+	explicit indexed_struct_array(const Allocator &alloc)
+		: rows{alloc}
+	{
+	}
+
+	// takes over existing rows and builds every index once
+	explicit indexed_struct_array(array_type array)
+		: rows{std::move(array)}
+	{
+		changed(0U);
+		refresh();
+	}
+
+	[[nodiscard]]
+	auto get_allocator() const noexcept -> allocator_type
+	{
+		return rows.get_allocator();
+	}
+
+	template <typename U>
+	requires std::is_same_v<T, std::decay_t<U>> || std::is_same_v<value_type, std::decay_t<U>>
+	void push_back(U &&value)
+	{
+		rows.push_back(std::forward<U>(value));
+		changed(std::size(rows) - 1U);
+	}
+
+	template <typename...Args>
+	requires (sizeof...(Args) == std::tuple_size_v<value_type>)
+	void emplace_back(Args &&...args)
+	{
+		rows.emplace_back(std::forward<Args>(args)...);
+		changed(std::size(rows) - 1U);
+	}
+
+	template <std::input_iterator It, std::sentinel_for<It> Sentinel>
+	void append(It first, const Sentinel last)
+	{
+		const auto n = std::size(rows);
+		try
+		{
+			rows.append(std::move(first), last);
+		}
+		catch (...)
+		{
+			changed(n);
+			throw;
+		}
+		changed(n);
+	}
+
+	auto erase(const const_iterator pos) -> const_iterator
+	{
+		return erase(pos, pos + 1);
+	}
+
+	auto erase(const const_iterator first, const const_iterator last) -> const_iterator
+	{
+		const auto index = first - std::cbegin(rows);
+		rows.erase(first, last);
+		changed(static_cast<size_type>(index));
+		return std::cbegin(rows) + index;
+	}
+
+	void pop_back()
+	{
+		rows.pop_back();
+		changed(std::size(rows));
+	}
+
+	void clear()
+	{
+		rows.clear();
+		changed(0U);
+	}
+
+	// calls f(reference) for row pos and tells the indexes afterwards, even if f throws
+	template <typename F>
+	void modify(const size_type pos, F &&f)
+	{
+		try
+		{
+			std::forward<F>(f)(rows[pos]);
+		}
+		catch (...)
+		{
+			modified(pos);
+			throw;
+		}
+		modified(pos);
+	}
+
+	// the N-th index, rebuilt first if it is stale
+	template <std::size_t N>
+	[[nodiscard]]
+	auto index() -> const std::tuple_element_t<N, index_types>&
+	{
+		auto &index = std::get<N>(indexes);
+		if (index.stale())
+			index.rebuild(rows);
+		return index;
+	}
+
+	// index<N>().rows(values(), args...), e.g. the rows with a key or a key range
+	template <std::size_t N, typename... Args>
+	[[nodiscard]]
+	auto find(Args &&...args)
+	{
+		return index<N>().rows(rows, std::forward<Args>(args)...);
+	}
+
+	// rebuilds every stale index now rather than on its next lookup
+	void refresh()
+	{
+		std::apply([&](auto &...index) { (..., (index.stale() ? index.rebuild(rows) : void())); }, indexes);
+	}
+
+	[[nodiscard]]
+	auto values() const noexcept -> const array_type&
+	{
+		return rows;
+	}
+
+	[[nodiscard]]
+	auto operator[](const size_type pos) const -> const_reference
+	{
+		return rows[pos];
+	}
+
+	[[nodiscard]]
+	auto begin() const noexcept -> const_iterator
+	{
+		return std::begin(rows);
+	}
+
+	[[nodiscard]]
+	auto end() const noexcept -> const_iterator
+	{
+		return std::end(rows);
+	}
+
+	template <std::size_t... Js>
+	[[nodiscard]]
+	auto project() const noexcept
+	{
+		return rows.template project<Js...>();
+	}
+
+	[[nodiscard]]
+	bool empty() const noexcept
+	{
+		return std::empty(rows);
+	}
+
+	[[nodiscard]]
+	auto size() const noexcept -> size_type
+	{
+		return std::size(rows);
+	}
+
+	void reserve(const size_type new_cap)
+	{
+		rows.reserve(new_cap);
+	}
+
+private:
+	array_type rows;
+	index_types indexes;
+
+	void changed(const size_type first)
+	{
+		std::apply([&](auto &...index) { (..., index.changed(rows, first)); }, indexes);
+	}
+
+	void modified(const size_type pos)
+	{
+		std::apply([&](auto &...index) { (..., index.modified(rows, pos)); }, indexes);
+	}
+};
+} // namespace soa
+
+#endif // SOA_INDEXED_STRUCT_ARRAY_H
@@ -0,0 +1,141 @@
+#ifndef SOA_LAYOUT_H
+#define SOA_LAYOUT_H
+
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "column_block.h"
+#include "column_chunks.h"
+#include "column_groups.h"
+#include "column_shared.h"
+#include "column_tiles.h"
+#include "stats.h"
+#include "to_tuple.h"
+#include "vectorize.h"
+
+namespace soa
+{
+inline static constexpr std::size_t cache_line_size = 64U;
+
+// fields stored together by layout::grouped, given as indices or member pointers
+template <auto... Fields>
+struct group
+{
+};
+
+namespace layout
+{
+// one std::vector per field
+struct vectors
+{
+};
+
+// all fields in a single allocation with one shared size and capacity
+template <std::size_t Alignment = cache_line_size>
+struct block
+{
+};
+
+// array of structures of arrays, every field of Lanes consecutive rows is stored contiguously
+// inside a tile and the tiles follow each other in a single allocation
+template <std::size_t Lanes = 16U>
+struct aosoa
+{
+};
+
+// fixed-size chunks of ChunkSize rows, each holding every field contiguously; growing adds chunks
+// and never moves existing rows
+template <std::size_t ChunkSize = 4096U>
+struct chunked
+{
+};
+
+// a single allocation like block, but the fields of every soa::group share one interleaved column,
+// e.g. grouped<group<0, 1, 2>> keeps x, y and z of a row next to each other
+template <typename... Groups>
+struct grouped
+{
+};
+
+// one std::vector per field like vectors, but copies of the array share the columns and a column
+// is only copied when one of them writes to it, so copying the array costs O(fields)
+struct copy_on_write
+{
+};
+} // namespace layout
+
+namespace impl
+{
+template <auto Field>
+inline static constexpr std::size_t field_position_v = []
+{
+	if constexpr (std::is_member_object_pointer_v<decltype(Field)>)
+		return member_index_v<Field>;
+	else
+		return static_cast<std::size_t>(Field);
+}();
+
+template <typename Group>
+struct group_indices;
+
+template <auto... Fields>
+struct group_indices<group<Fields...>>
+{
+	using type = std::index_sequence<field_position_v<Fields>...>;
+};
+
+template <typename Layout, typename T, typename Allocator>
+struct storage_impl;
+
+template <typename... Ts, typename Allocator>
+struct storage_impl<layout::vectors, std::tuple<Ts...>, Allocator>
+{
+	using type = column_vectors<std::tuple<Ts...>, std::index_sequence_for<Ts...>, Allocator>;
+};
+
+template <typename... Ts, typename Allocator>
+struct storage_impl<layout::copy_on_write, std::tuple<Ts...>, Allocator>
+{
+	using type = column_shared<std::tuple<Ts...>, std::index_sequence_for<Ts...>, Allocator>;
+};
+
+template <std::size_t Alignment, typename... Ts, typename Allocator>
+struct storage_impl<layout::block<Alignment>, std::tuple<Ts...>, Allocator>
+{
+	using type = column_block<contiguous_addressing<Alignment, Ts...>, std::tuple<Ts...>,
+	                          std::index_sequence_for<Ts...>, Allocator>;
+};
+
+template <std::size_t Lanes, typename... Ts, typename Allocator>
+struct storage_impl<layout::aosoa<Lanes>, std::tuple<Ts...>, Allocator>
+{
+	using type = column_block<tile_addressing<Lanes, cache_line_size, Ts...>, std::tuple<Ts...>,
+	                          std::index_sequence_for<Ts...>, Allocator>;
+};
+
+template <std::size_t ChunkSize, typename... Ts, typename Allocator>
+struct storage_impl<layout::chunked<ChunkSize>, std::tuple<Ts...>, Allocator>
+{
+	using type = column_chunks<ChunkSize, cache_line_size, std::tuple<Ts...>, std::index_sequence_for<Ts...>, Allocator>;
+};
+
+template <typename... Groups, typename... Ts, typename Allocator>
+struct storage_impl<layout::grouped<Groups...>, std::tuple<Ts...>, Allocator>
+{
+	using type = column_block<group_addressing<cache_line_size, std::tuple<typename group_indices<Groups>::type...>,
+	                                           std::tuple<Ts...>, std::index_sequence_for<Ts...>>,
+	                          std::tuple<Ts...>, std::index_sequence_for<Ts...>, Allocator>;
+};
+} // namespace impl
+
+template <typename T, typename Layout = layout::vectors, typename Allocator = std::allocator<std::byte>>
+using storage = impl::storage_impl<Layout, to_tuple_t<T>, Allocator>;
+
+template <typename T, typename Layout = layout::vectors, typename Allocator = std::allocator<std::byte>>
+using storage_t = impl::instrumented_t<typename storage<T, Layout, Allocator>::type, std::tuple_size_v<to_tuple_t<T>>>;
+} // namespace soa
+
+#endif // SOA_LAYOUT_H
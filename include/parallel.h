@@ -0,0 +1,343 @@
+#ifndef SOA_PARALLEL_H
+#define SOA_PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "aos.h"
+#include "layout.h"
+#include "projection.h"
+#include "simd.h"
+#include "thread_pool.h"
+
+// Parallel algorithms over struct_array. The rows are cut into contiguous index ranges whose
+// boundaries fall on cache line boundaries of the memory the workers write: the column transform
+// writes and sort permutes, the output of to_aos and gather, the column of a one column for_each.
+// The first range takes the rows in front of the first line, so no two workers share a line they
+// write. A for_each over several columns places the boundaries on whole lines from every column
+// start instead, which are real line boundaries in the block, aosoa and grouped layouts but not
+// in the columns of layout::vectors, which the allocator may only align to 16 bytes.
+namespace soa
+{
+template <typename E>
+concept executor = std::is_execution_policy_v<std::remove_cvref_t<E>>
+	|| std::is_same_v<std::remove_cvref_t<E>, thread_pool>;
+
+namespace impl
+{
+// rows per chunk below which splitting costs more than it gains
+inline static constexpr std::size_t min_chunk_rows = 4096U;
+
+// chunks handed to every thread, more than one to even out imbalance
+inline static constexpr std::size_t chunks_per_thread = 4U;
+
+template <typename A>
+using columns_t = decltype(std::declval<A &>().data());
+
+// smallest row count that is a whole number of cache lines in every column
+template <typename... Ts>
+[[nodiscard]]
+constexpr auto rows_per_line(std::tuple<Ts *...>) noexcept -> std::size_t
+{
+	std::size_t rows = 1U;
+	(..., (rows = std::lcm(rows, cache_line_size / std::gcd(cache_line_size, sizeof(Ts)))));
+	return rows;
+}
+
+// rows of column in front of the first one that starts a cache line, 0 if none does
+template <typename T>
+[[nodiscard]]
+auto rows_to_line(T *const column) noexcept -> std::size_t
+{
+	const auto address = reinterpret_cast<std::uintptr_t>(column);
+	for (std::size_t row = 0U; row < rows_per_line(std::tuple<T *>{}); ++row)
+		if ((address + row * sizeof(T)) % cache_line_size == 0U)
+			return row;
+	return 0U;
+}
+
+template <typename E>
+[[nodiscard]]
+auto concurrency(E &exec) noexcept -> std::size_t
+{
+	using P = std::remove_cvref_t<E>;
+	if constexpr (std::is_same_v<P, thread_pool>)
+		return exec.size();
+	else if constexpr (std::is_same_v<P, std::execution::sequenced_policy>)
+		return 1U;
+	else
+		return thread_pool::global().size();
+}
+
+// calls task(i) for i in [0, tasks) on the executor, par and par_unseq use the global pool
+template <typename E, typename F>
+void parallel_for(E &exec, const std::size_t tasks, F &&task)
+{
+	using P = std::remove_cvref_t<E>;
+	if constexpr (std::is_same_v<P, thread_pool>)
+		exec.run(tasks, task);
+	else if constexpr (std::is_same_v<P, std::execution::sequenced_policy>)
+	{
+		for (std::size_t i = 0U; i < tasks; ++i)
+			task(i);
+	}
+	else
+		thread_pool::global().run(tasks, task);
+}
+
+// chunk i covers the rows [i * rows - shift, (i + 1) * rows - shift) clamped to [0, n)
+struct chunking
+{
+	std::size_t rows;
+	std::size_t chunks;
+	std::size_t shift = 0U;
+};
+
+// chunks of whole multiples of granularity rows, the first one shortened by shift
+template <typename E>
+[[nodiscard]]
+auto chunks_of(E &exec, const std::size_t n, const std::size_t granularity, const std::size_t head) noexcept
+	-> chunking
+{
+	if (n == 0U)
+		return {granularity, 0U};
+
+	const auto tasks = concurrency(exec) * chunks_per_thread;
+	auto rows = std::max(min_chunk_rows, (n + tasks - 1U) / tasks);
+	rows = (rows + granularity - 1U) / granularity * granularity;
+	const auto shift = (rows - head) % rows;
+	return {rows, (n + shift + rows - 1U) / rows, shift};
+}
+
+// chunks that are a whole number of lines in every column, counted from the column starts
+template <typename A, typename E>
+[[nodiscard]]
+auto chunks_of(E &exec, const std::size_t n) noexcept -> chunking
+{
+	return chunks_of(exec, n, rows_per_line(columns_t<A>{}), 0U);
+}
+
+// chunks whose boundaries fall on cache lines of written, which holds the n rows
+template <typename E, typename T>
+[[nodiscard]]
+auto chunks_of(E &exec, const std::size_t n, T *const written) noexcept -> chunking
+{
+	return chunks_of(exec, n, rows_per_line(std::tuple<T *>{}), rows_to_line(written));
+}
+
+template <typename E, typename F>
+void for_each_chunk(E &exec, const std::size_t n, const chunking &split, F &&f)
+{
+	const auto [rows, chunks, shift] = split;
+	parallel_for(exec, chunks, [&](const std::size_t i)
+	{
+		const auto first = i * rows;
+		f(first > shift ? first - shift : 0U, std::min(n, first + rows - shift));
+	});
+}
+
+// calls f(first, last) for consecutive row ranges covering [0, n), a whole number of lines in
+// every column
+template <typename A, typename E, typename F>
+void for_each_chunk(E &exec, const std::size_t n, F &&f)
+{
+	for_each_chunk(exec, n, chunks_of<A>(exec, n), f);
+}
+
+// calls f(first, last) for consecutive row ranges covering [0, n) whose boundaries fall on cache
+// lines of written
+template <typename E, typename T, typename F>
+void for_each_chunk(E &exec, const std::size_t n, T *const written, F &&f)
+{
+	for_each_chunk(exec, n, chunks_of(exec, n, written), f);
+}
+
+template <typename E, typename A, typename F, std::size_t... Is>
+void for_each(E &exec, A &array, F &f, std::index_sequence<Is...>)
+{
+	const auto columns = array.data();
+	const auto rows = [&](const std::size_t first, const std::size_t last)
+	{
+		for (auto i = first; i < last; ++i)
+			f(std::get<Is>(columns)[i]...);
+	};
+
+	if constexpr (sizeof...(Is) == 1U)
+		for_each_chunk(exec, std::size(array), std::get<Is...>(columns), rows);
+	else
+		for_each_chunk<A>(exec, std::size(array), rows);
+}
+
+// the rows [first, first + count) of columns as a projection; callers take array.data() once
+// before splitting, since data() may copy the columns of a copy on write array
+template <typename... Ts>
+[[nodiscard]]
+auto slice(const std::tuple<Ts *...> &columns, const std::size_t first, const std::size_t count)
+	-> projection<std::tuple<Ts *...>>
+{
+	return std::apply([&](auto *const ...column) -> projection<std::tuple<Ts *...>>
+	{
+		return {{(column + first)...}, count};
+	}, columns);
+}
+
+// moves row perm[i] of every column to row i, one column at a time through a scratch buffer
+// taken from the array's allocator
+template <typename E, typename A, std::size_t... Is>
+void apply_permutation(E &&exec, A &array, const std::vector<std::size_t> &perm, std::index_sequence<Is...>)
+{
+	const auto n = perm.size();
+	const auto columns = array.data();
+
+	(..., [&](auto *const column)
+	{
+		using T = std::remove_pointer_t<decltype(column)>;
+		static_assert(std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>,
+		              "permuting a column requires nothrow moves");
+
+		using array_traits = std::allocator_traits<typename std::remove_cvref_t<A>::allocator_type>;
+		using traits = typename array_traits::template rebind_traits<T>;
+		typename traits::allocator_type allocator{array.get_allocator()};
+		const auto block = traits::allocate(allocator, n);
+		auto *const scratch = std::to_address(block);
+
+		for_each_chunk(exec, n, scratch, [&](const std::size_t first, const std::size_t last)
+		{
+			for (auto i = first; i < last; ++i)
+				std::construct_at(scratch + i, std::move(column[perm[i]]));
+		});
+		for_each_chunk(exec, n, column, [&](const std::size_t first, const std::size_t last)
+		{
+			std::move(scratch + first, scratch + last, column + first);
+			std::destroy(scratch + first, scratch + last);
+		});
+
+		traits::deallocate(allocator, block, n);
+	}(std::get<Is>(columns)));
+}
+} // namespace impl
+
+// calls f with the columns Is... (all columns if none are given) of every row
+template <std::size_t... Is, executor E, typename A, typename F>
+void for_each(E &&exec, A &&array, F &&f)
+{
+	if constexpr (sizeof...(Is) == 0U)
+		impl::for_each(exec, array, f, std::make_index_sequence<std::tuple_size_v<impl::columns_t<A>>>{});
+	else
+		impl::for_each(exec, array, f, std::index_sequence<Is...>{});
+}
+
+// column Out = f(column In...), every chunk runs the simd::transform kernel
+template <std::size_t Out, std::size_t... In, executor E, typename A, typename F>
+void transform(E &&exec, A &&array, F &&f)
+{
+	const auto columns = array.data();
+	impl::for_each_chunk(exec, std::size(array), std::get<Out>(columns), [&](const std::size_t first, const std::size_t last)
+	{
+		simd::transform<Out, In...>(impl::slice(columns, first, last - first), f);
+	});
+}
+
+// folds column I with op, which has to be associative, starting from init
+template <std::size_t I, executor E, typename A, typename T, typename Op = std::plus<>>
+[[nodiscard]]
+auto reduce(E &&exec, const A &array, T init, Op op = {}) -> T
+{
+	const auto *const column = std::get<I>(array.data());
+	const auto n = std::size(array);
+
+	const auto split = impl::chunks_of<A>(exec, n);
+	std::vector<std::optional<T>> partials(split.chunks);
+	impl::for_each_chunk(exec, n, split, [&](const std::size_t first, const std::size_t last)
+	{
+		auto partial = static_cast<T>(column[first]);
+		for (auto i = first + 1U; i < last; ++i)
+			partial = op(std::move(partial), column[i]);
+		partials[first / split.rows].emplace(std::move(partial));
+	});
+
+	for (auto &partial : partials)
+		if (partial)
+			init = op(std::move(init), std::move(*partial));
+	return init;
+}
+
+// sorts the rows by comp(const_reference, const_reference): sorts row indices in parallel runs,
+// merges them pairwise and then permutes every column once
+template <executor E, typename A, typename Compare>
+void sort(E &&exec, A &&array, Compare comp)
+{
+	const auto n = std::size(array);
+	const auto &rows = std::as_const(array);
+
+	std::vector<std::size_t> perm(n);
+	std::iota(std::begin(perm), std::end(perm), std::size_t{0U});
+
+	const auto less = [&](const std::size_t l, const std::size_t r) { return comp(rows[l], rows[r]); };
+
+	const auto threads = impl::concurrency(exec);
+	const auto run_rows = std::max(impl::min_chunk_rows, (n + threads - 1U) / threads);
+	std::vector<std::pair<std::size_t, std::size_t>> runs;
+	for (std::size_t first = 0U; first < n; first += run_rows)
+		runs.emplace_back(first, std::min(n, first + run_rows));
+
+	impl::parallel_for(exec, runs.size(), [&](const std::size_t i)
+	{
+		std::sort(std::begin(perm) + runs[i].first, std::begin(perm) + runs[i].second, less);
+	});
+
+	std::vector<std::size_t> buffer(n);
+	while (runs.size() > 1U)
+	{
+		std::vector<std::pair<std::size_t, std::size_t>> merged((runs.size() + 1U) / 2U);
+		impl::parallel_for(exec, merged.size(), [&](const std::size_t i)
+		{
+			const auto [first, middle] = runs[2U * i];
+			const auto last = 2U * i + 1U < runs.size() ? runs[2U * i + 1U].second : middle;
+			std::merge(std::begin(perm) + first, std::begin(perm) + middle, std::begin(perm) + middle,
+			           std::begin(perm) + last, std::begin(buffer) + first, less);
+			merged[i] = {first, last};
+		});
+		perm.swap(buffer);
+		runs.swap(merged);
+	}
+
+	impl::apply_permutation(exec, array, perm,
+	                        std::make_index_sequence<std::tuple_size_v<impl::columns_t<A>>>{});
+}
+
+// to_aos into out, which points to size() objects, every chunk fills its own part of out
+template <executor E, typename A>
+void to_aos(E &&exec, const A &array, impl::struct_type_t<A> *const out)
+{
+	impl::for_each_chunk(exec, std::size(array), out, [&](const std::size_t first, const std::size_t last)
+	{
+		impl::to_aos(array, first, last, out + first, impl::struct_indices_t<A>{});
+	});
+}
+
+// gather with the indices split into chunks
+template <executor E, typename A, std::ranges::random_access_range Indices>
+requires std::integral<std::ranges::range_value_t<Indices>>
+void gather(E &&exec, const A &array, const Indices &indices, impl::struct_type_t<A> *const out)
+{
+	impl::for_each_chunk(exec, std::ranges::size(indices), out, [&](const std::size_t first, const std::size_t last)
+	{
+		impl::gather(array, std::ranges::begin(indices) + static_cast<std::ptrdiff_t>(first), last - first,
+		             out + first, impl::struct_indices_t<A>{});
+	});
+}
+} // namespace soa
+
+#endif // SOA_PARALLEL_H
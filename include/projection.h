@@ -0,0 +1,93 @@
+#ifndef SOA_PROJECTION_H
+#define SOA_PROJECTION_H
+
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <tuple>
+#include <utility>
+
+#include "struct_array_iterator.h"
+
+namespace soa
+{
+namespace impl
+{
+template <typename U, typename = std::make_index_sequence<std::tuple_size_v<U>>>
+struct projection;
+
+// non-owning view over a subset of the columns of a struct_array, its iterator
+// only carries (and only advances) the selected columns
+template <typename U, std::size_t... Is>
+struct projection<U, std::index_sequence<Is...>>
+{
+	using iterator = struct_array_iterator<U, std::index_sequence<Is...>>;
+	using value_type = typename iterator::value_type;
+	using reference = typename iterator::reference;
+	using pointer = typename iterator::pointer;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+
+	U first;
+	size_type count;
+
+	[[nodiscard]]
+	auto begin() const noexcept -> iterator
+	{
+		return {std::get<Is>(first)...};
+	}
+
+	[[nodiscard]]
+	auto end() const noexcept -> iterator
+	{
+		return begin() + static_cast<difference_type>(count);
+	}
+
+	[[nodiscard]]
+	auto operator[](const size_type pos) const noexcept -> reference
+	{
+		return begin()[static_cast<difference_type>(pos)];
+	}
+
+	[[nodiscard]]
+	auto front() const noexcept -> reference
+	{
+		return *begin();
+	}
+
+	[[nodiscard]]
+	auto back() const noexcept -> reference
+	{
+		return *(end() - 1);
+	}
+
+	[[nodiscard]]
+	auto data() const noexcept -> pointer
+	{
+		return {std::to_address(std::get<Is>(first))...};
+	}
+
+	[[nodiscard]]
+	bool empty() const noexcept
+	{
+		return count == 0U;
+	}
+
+	[[nodiscard]]
+	auto size() const noexcept -> size_type
+	{
+		return count;
+	}
+
+	// the I-th selected column as a contiguous range
+	template <std::size_t I>
+	[[nodiscard]]
+	auto column() const noexcept
+	{
+		return std::ranges::subrange{std::get<I>(first), std::get<I>(first) + static_cast<difference_type>(count)};
+	}
+};
+} // namespace impl
+} // namespace soa
+
+#endif // SOA_PROJECTION_H
@@ -0,0 +1,700 @@
+#ifndef SOA_QUERY_H
+#define SOA_QUERY_H
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bitmask.h"
+#include "compact.h"
+#include "projection.h"
+#include "simd.h"
+
+// Column-at-a-time queries. A predicate is built from column placeholders and values,
+//
+//   using namespace soa::query;
+//   const auto hits = select(array, col<0> > 0.5F && (col<2> == 3 || !(col<1> < 10)));
+//
+// and evaluated leaf by leaf into a bitmask; a leaf only reads the columns it names and runs
+// through simd::mask when they are contiguous, the scalar loop otherwise. The mask (or a
+// selection vector of row indices made from it by rows) then feeds aggregate, group_by and
+// for_each, which again only touch the columns they are given.
+namespace soa
+{
+namespace query
+{
+namespace impl
+{
+// element type of a lane argument, plain values and simd vectors alike
+template <typename X>
+struct lane
+{
+	using type = X;
+};
+
+#if SOA_HAS_SIMD
+template <typename T, typename Abi>
+struct lane<simd::impl::stdx::simd<T, Abi>>
+{
+	using type = T;
+};
+#endif
+
+template <typename X>
+using lane_t = typename lane<X>::type;
+
+template <typename Op, typename V>
+struct compare_with
+{
+	V value;
+
+	template <typename X>
+	[[nodiscard]]
+	auto operator()(const X &x) const
+	{
+		return Op{}(x, static_cast<lane_t<X>>(value));
+	}
+};
+
+template <typename A, std::size_t I>
+using column_iterator_t = std::tuple_element_t<0U, decltype(std::declval<const A &>().template project<I>().first)>;
+
+// iterator to the start of column I
+template <std::size_t I, typename A>
+[[nodiscard]]
+auto column_begin(const A &array) noexcept -> column_iterator_t<A, I>
+{
+	return std::get<0U>(array.template project<I>().first);
+}
+
+template <typename T>
+[[nodiscard]]
+constexpr auto key_value(const T key) noexcept -> std::int64_t
+{
+	if constexpr (std::is_enum_v<T>)
+		return static_cast<std::int64_t>(static_cast<std::underlying_type_t<T>>(key));
+	else
+		return static_cast<std::int64_t>(key);
+}
+} // namespace impl
+
+// leaf of a predicate, pred(column In[i]...) with the simd::mask conventions
+template <typename F, std::size_t... In>
+struct where_node
+{
+	F pred;
+};
+
+template <typename L, typename R>
+struct and_node
+{
+	L lhs;
+	R rhs;
+};
+
+template <typename L, typename R>
+struct or_node
+{
+	L lhs;
+	R rhs;
+};
+
+template <typename P>
+struct not_node
+{
+	P operand;
+};
+
+template <typename T>
+inline static constexpr bool is_predicate_v = false;
+
+template <typename F, std::size_t... In>
+inline static constexpr bool is_predicate_v<where_node<F, In...>> = true;
+
+template <typename L, typename R>
+inline static constexpr bool is_predicate_v<and_node<L, R>> = true;
+
+template <typename L, typename R>
+inline static constexpr bool is_predicate_v<or_node<L, R>> = true;
+
+template <typename P>
+inline static constexpr bool is_predicate_v<not_node<P>> = true;
+
+template <typename T>
+concept predicate = is_predicate_v<std::remove_cvref_t<T>>;
+
+template <typename T>
+concept scalar = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+
+template <std::size_t... In, typename F>
+requires (sizeof...(In) > 0U)
+[[nodiscard]]
+auto where(F &&pred) -> where_node<std::decay_t<F>, In...>
+{
+	return {std::forward<F>(pred)};
+}
+
+// placeholder for column I, compared against a value it becomes a predicate; the value is
+// converted to the column type first
+template <std::size_t I>
+struct column_ref
+{
+};
+
+template <std::size_t I>
+inline static constexpr column_ref<I> col{};
+
+namespace impl
+{
+template <typename Op, std::size_t I, typename V>
+[[nodiscard]]
+auto compare(const V value) -> where_node<compare_with<Op, V>, I>
+{
+	return {{value}};
+}
+} // namespace impl
+
+template <std::size_t I, scalar V>
+[[nodiscard]]
+auto operator==(column_ref<I>, const V value)
+{
+	return impl::compare<std::equal_to<>, I>(value);
+}
+
+template <std::size_t I, scalar V>
+[[nodiscard]]
+auto operator!=(column_ref<I>, const V value)
+{
+	return impl::compare<std::not_equal_to<>, I>(value);
+}
+
+template <std::size_t I, scalar V>
+[[nodiscard]]
+auto operator<(column_ref<I>, const V value)
+{
+	return impl::compare<std::less<>, I>(value);
+}
+
+template <std::size_t I, scalar V>
+[[nodiscard]]
+auto operator<=(column_ref<I>, const V value)
+{
+	return impl::compare<std::less_equal<>, I>(value);
+}
+
+template <std::size_t I, scalar V>
+[[nodiscard]]
+auto operator>(column_ref<I>, const V value)
+{
+	return impl::compare<std::greater<>, I>(value);
+}
+
+template <std::size_t I, scalar V>
+[[nodiscard]]
+auto operator>=(column_ref<I>, const V value)
+{
+	return impl::compare<std::greater_equal<>, I>(value);
+}
+
+template <std::size_t I, scalar V>
+[[nodiscard]]
+auto operator==(const V value, const column_ref<I> column)
+{
+	return column == value;
+}
+
+template <std::size_t I, scalar V>
+[[nodiscard]]
+auto operator!=(const V value, const column_ref<I> column)
+{
+	return column != value;
+}
+
+template <std::size_t I, scalar V>
+[[nodiscard]]
+auto operator<(const V value, const column_ref<I> column)
+{
+	return column > value;
+}
+
+template <std::size_t I, scalar V>
+[[nodiscard]]
+auto operator<=(const V value, const column_ref<I> column)
+{
+	return column >= value;
+}
+
+template <std::size_t I, scalar V>
+[[nodiscard]]
+auto operator>(const V value, const column_ref<I> column)
+{
+	return column < value;
+}
+
+template <std::size_t I, scalar V>
+[[nodiscard]]
+auto operator>=(const V value, const column_ref<I> column)
+{
+	return column <= value;
+}
+
+template <predicate L, predicate R>
+[[nodiscard]]
+auto operator&&(L &&lhs, R &&rhs) -> and_node<std::remove_cvref_t<L>, std::remove_cvref_t<R>>
+{
+	return {std::forward<L>(lhs), std::forward<R>(rhs)};
+}
+
+template <predicate L, predicate R>
+[[nodiscard]]
+auto operator||(L &&lhs, R &&rhs) -> or_node<std::remove_cvref_t<L>, std::remove_cvref_t<R>>
+{
+	return {std::forward<L>(lhs), std::forward<R>(rhs)};
+}
+
+template <predicate P>
+[[nodiscard]]
+auto operator!(P &&operand) -> not_node<std::remove_cvref_t<P>>
+{
+	return {std::forward<P>(operand)};
+}
+
+namespace impl
+{
+template <typename A, typename F, std::size_t... In>
+[[nodiscard]]
+auto evaluate(const A &array, const where_node<F, In...> &node) -> bitmask
+{
+	const auto columns = array.template project<In...>();
+
+	return [&]<std::size_t... Ks>(std::index_sequence<Ks...>)
+	{
+		if constexpr ((... && std::contiguous_iterator<column_iterator_t<A, In>>))
+			return simd::mask<Ks...>(columns, node.pred);
+		else
+		{
+			const auto n = std::size(array);
+			bitmask result{n};
+			for (std::size_t i = 0U; i < n; ++i)
+				result.set(i, static_cast<bool>(node.pred(std::get<Ks>(columns.first)[static_cast<std::ptrdiff_t>(i)]...)));
+			return result;
+		}
+	}(std::make_index_sequence<sizeof...(In)>{});
+}
+
+// the right operand is skipped when the left one already decides every row
+template <typename A, typename L, typename R>
+[[nodiscard]]
+auto evaluate(const A &array, const and_node<L, R> &node) -> bitmask
+{
+	auto result = evaluate(array, node.lhs);
+	if (result.any())
+		result &= evaluate(array, node.rhs);
+	return result;
+}
+
+template <typename A, typename L, typename R>
+[[nodiscard]]
+auto evaluate(const A &array, const or_node<L, R> &node) -> bitmask
+{
+	auto result = evaluate(array, node.lhs);
+	if (result.count() != std::size(result))
+		result |= evaluate(array, node.rhs);
+	return result;
+}
+
+template <typename A, typename P>
+[[nodiscard]]
+auto evaluate(const A &array, const not_node<P> &node) -> bitmask
+{
+	return evaluate(array, node.operand).flip();
+}
+
+// calls range(first, last) for every run of fully set mask words and row(i) for the other
+// selected rows, in order
+template <typename Row, typename Range>
+void for_each_selected(const bitmask &selection, Row &&row, Range &&range)
+{
+	std::size_t base = 0U;
+	std::size_t run = 0U;
+	for (auto word : selection.words())
+	{
+		if (word != ~bitmask::word_type{0U})
+		{
+			if (run != base)
+				range(run, base);
+			for (; word != 0U; word &= word - 1U)
+				row(base + static_cast<std::size_t>(std::countr_zero(word)));
+			run = base + bitmask::word_bits;
+		}
+		base += bitmask::word_bits;
+	}
+	if (run != base)
+		range(run, base);
+}
+
+template <typename Row, typename Range>
+void for_each_selected(const std::span<const std::size_t> selection, Row &&row, Range &&)
+{
+	for (const auto i : selection)
+		row(i);
+}
+
+template <typename A>
+void check_selection(const A &array, const bitmask &selection)
+{
+	soa::impl::check_mask(std::size(array), selection);
+}
+
+template <typename A>
+void check_selection(const A &, std::span<const std::size_t>) noexcept
+{
+}
+
+// folds rows [first, last) of column into init with op: the simd::reduce kernel, with hop
+// reducing its vectors, where the column is contiguous, a plain loop otherwise
+template <typename T, typename It, typename Op, typename HOp>
+[[nodiscard]]
+auto fold_range(const It column, const std::size_t first, const std::size_t last, const T init, Op &&op, HOp &&hop) -> T
+{
+	if constexpr (std::contiguous_iterator<It>)
+	{
+		const soa::impl::projection<std::tuple<const std::iter_value_t<It> *>> rows{{std::to_address(column) + first}, last - first};
+		return simd::reduce<0U>(rows, init, op, hop);
+	}
+	else
+	{
+		auto result = init;
+		for (auto i = first; i < last; ++i)
+			result = op(result, static_cast<T>(column[static_cast<std::iter_difference_t<It>>(i)]));
+		return result;
+	}
+}
+
+// integral sums widen to 64 bits so they do not overflow on long columns
+template <typename T>
+using sum_t = std::conditional_t<std::is_floating_point_v<T>, T,
+	std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>;
+
+template <typename It>
+struct bound_sum
+{
+	using state_type = sum_t<std::iter_value_t<It>>;
+	using result_type = state_type;
+
+	It column;
+
+	[[nodiscard]]
+	auto init() const noexcept -> state_type
+	{
+		return {};
+	}
+
+	void add(state_type &state, const std::size_t i) const
+	{
+		state += static_cast<state_type>(column[static_cast<std::iter_difference_t<It>>(i)]);
+	}
+
+	void add_range(state_type &state, const std::size_t first, const std::size_t last) const
+	{
+		state += fold_range(column, first, last, state_type{}, std::plus<>{}, [](const auto &v) { return reduce(v); });
+	}
+
+	[[nodiscard]]
+	auto result(const state_type state) const noexcept -> result_type
+	{
+		return state;
+	}
+};
+
+struct bound_count
+{
+	using state_type = std::size_t;
+	using result_type = std::size_t;
+
+	[[nodiscard]]
+	auto init() const noexcept -> state_type
+	{
+		return 0U;
+	}
+
+	void add(state_type &state, std::size_t) const noexcept
+	{
+		++state;
+	}
+
+	void add_range(state_type &state, const std::size_t first, const std::size_t last) const noexcept
+	{
+		state += last - first;
+	}
+
+	[[nodiscard]]
+	auto result(const state_type state) const noexcept -> result_type
+	{
+		return state;
+	}
+};
+
+// Compare is std::less<> for min and std::greater<> for max, init() is its identity
+template <typename It, typename Compare>
+struct bound_extremum
+{
+	using state_type = std::iter_value_t<It>;
+	using result_type = state_type;
+
+	It column;
+
+	[[nodiscard]]
+	auto init() const noexcept -> state_type
+	{
+		if constexpr (std::is_same_v<Compare, std::less<>>)
+			return std::numeric_limits<state_type>::max();
+		else
+			return std::numeric_limits<state_type>::lowest();
+	}
+
+	void add(state_type &state, const std::size_t i) const
+	{
+		const state_type value = column[static_cast<std::iter_difference_t<It>>(i)];
+		state = Compare{}(value, state) ? value : state;
+	}
+
+	void add_range(state_type &state, const std::size_t first, const std::size_t last) const
+	{
+		using std::min;
+		using std::max;
+
+		state_type value;
+		if constexpr (std::is_same_v<Compare, std::less<>>)
+			value = fold_range(column, first, last, init(), [](const auto &l, const auto &r) { return min(l, r); },
+			                   [](const auto &v) { return hmin(v); });
+		else
+			value = fold_range(column, first, last, init(), [](const auto &l, const auto &r) { return max(l, r); },
+			                   [](const auto &v) { return hmax(v); });
+		state = Compare{}(value, state) ? value : state;
+	}
+
+	[[nodiscard]]
+	auto result(const state_type state) const noexcept -> result_type
+	{
+		return state;
+	}
+};
+} // namespace impl
+
+// aggregates, passed by value to aggregate and group_by, e.g. aggregate(array, hits, sum<2>, count)
+template <std::size_t I>
+struct sum_of
+{
+	template <typename A>
+	[[nodiscard]]
+	auto bind(const A &array) const noexcept
+	{
+		return impl::bound_sum<impl::column_iterator_t<A, I>>{impl::column_begin<I>(array)};
+	}
+};
+
+struct count_of
+{
+	template <typename A>
+	[[nodiscard]]
+	auto bind(const A &) const noexcept -> impl::bound_count
+	{
+		return {};
+	}
+};
+
+// std::numeric_limits<T>::max() if nothing is selected, like simd::min
+template <std::size_t I>
+struct min_of
+{
+	template <typename A>
+	[[nodiscard]]
+	auto bind(const A &array) const noexcept
+	{
+		return impl::bound_extremum<impl::column_iterator_t<A, I>, std::less<>>{impl::column_begin<I>(array)};
+	}
+};
+
+// std::numeric_limits<T>::lowest() if nothing is selected, like simd::max
+template <std::size_t I>
+struct max_of
+{
+	template <typename A>
+	[[nodiscard]]
+	auto bind(const A &array) const noexcept
+	{
+		return impl::bound_extremum<impl::column_iterator_t<A, I>, std::greater<>>{impl::column_begin<I>(array)};
+	}
+};
+
+template <std::size_t I>
+inline static constexpr sum_of<I> sum{};
+
+inline static constexpr count_of count{};
+
+template <std::size_t I>
+inline static constexpr min_of<I> min{};
+
+template <std::size_t I>
+inline static constexpr max_of<I> max{};
+
+// bit i is set if pred holds for row i
+template <typename A, predicate P>
+[[nodiscard]]
+auto select(const A &array, const P &pred) -> bitmask
+{
+	return impl::evaluate(array, pred);
+}
+
+// selection vector: the indices of the set bits, ascending
+[[nodiscard]]
+inline auto rows(const bitmask &selection) -> std::vector<std::size_t>
+{
+	std::vector<std::size_t> result;
+	result.reserve(selection.count());
+	impl::for_each_selected(selection,
+		[&](const std::size_t i) { result.push_back(i); },
+		[&](std::size_t first, const std::size_t last)
+		{
+			for (; first < last; ++first)
+				result.push_back(first);
+		});
+	return result;
+}
+
+// calls f(column In[i]...) for every selected row i, in order; selection is a bitmask of size()
+// bits or a selection vector of indices below size()
+template <std::size_t... In, typename A, typename Selection, typename F>
+requires (sizeof...(In) > 0U)
+void for_each(A &&array, const Selection &selection, F &&f)
+{
+	impl::check_selection(array, selection);
+
+	const auto columns = array.template project<In...>().first;
+	const auto row = [&](const std::size_t i)
+	{
+		std::apply([&](const auto &...column) { f(column[static_cast<std::ptrdiff_t>(i)]...); }, columns);
+	};
+	impl::for_each_selected(selection, row, [&](std::size_t first, const std::size_t last)
+	{
+		for (; first < last; ++first)
+			row(first);
+	});
+}
+
+// one result per aggregate over the selected rows, e.g.
+//   const auto [total, n] = aggregate(array, select(array, col<0> > 0), sum<1>, count);
+template <typename A, typename Selection, typename... Aggregates>
+[[nodiscard]]
+auto aggregate(const A &array, const Selection &selection, const Aggregates &...aggregates)
+{
+	impl::check_selection(array, selection);
+
+	const auto bound = std::tuple{aggregates.bind(array)...};
+	return std::apply([&](const auto &...bs)
+	{
+		auto states = std::tuple{bs.init()...};
+		impl::for_each_selected(selection,
+			[&](const std::size_t i)
+			{
+				std::apply([&](auto &...state) { (..., bs.add(state, i)); }, states);
+			},
+			[&](const std::size_t first, const std::size_t last)
+			{
+				std::apply([&](auto &...state) { (..., bs.add_range(state, first, last)); }, states);
+			});
+		return std::apply([&](const auto &...state) { return std::tuple{bs.result(state)...}; }, states);
+	}, bound);
+}
+
+// widest key range group_by will allocate state for
+inline static constexpr std::size_t max_group_keys = std::size_t{1U} << 20U;
+
+// aggregates per distinct value of the integral or enum column K over the selected rows; the
+// states live in a dense table indexed by key - min_key, so the key range (not just the number
+// of distinct keys) has to stay below max_group_keys. Returns (key, results) pairs of the keys
+// that occur, ascending
+template <std::size_t K, typename A, typename Selection, typename... Aggregates>
+[[nodiscard]]
+auto group_by(const A &array, const Selection &selection, const Aggregates &...aggregates)
+{
+	using key_type = std::iter_value_t<impl::column_iterator_t<A, K>>;
+	static_assert(std::is_integral_v<key_type> || std::is_enum_v<key_type>, "group_by needs an integral or enum key");
+
+	impl::check_selection(array, selection);
+
+	const auto keys = impl::column_begin<K>(array);
+	const auto key_at = [&](const std::size_t i)
+	{
+		return impl::key_value(keys[static_cast<std::iter_difference_t<decltype(keys)>>(i)]);
+	};
+
+	const auto bound = std::tuple{aggregates.bind(array)...};
+	return std::apply([&](const auto &...bs)
+	{
+		using results_type = std::tuple<typename std::remove_cvref_t<decltype(bs)>::result_type...>;
+		std::vector<std::pair<key_type, results_type>> result;
+
+		auto lowest = std::numeric_limits<std::int64_t>::max();
+		auto highest = std::numeric_limits<std::int64_t>::lowest();
+		const auto widen = [&](const std::size_t i)
+		{
+			const auto key = key_at(i);
+			lowest = std::min(lowest, key);
+			highest = std::max(highest, key);
+		};
+		impl::for_each_selected(selection, widen, [&](std::size_t first, const std::size_t last)
+		{
+			for (; first < last; ++first)
+				widen(first);
+		});
+		if (lowest > highest)
+			return result;
+
+		if (static_cast<std::uint64_t>(highest) - static_cast<std::uint64_t>(lowest) >= max_group_keys)
+			throw std::length_error{"soa::query::group_by: key range too large"};
+
+		const auto range = static_cast<std::size_t>(highest - lowest) + 1U;
+		std::vector<std::tuple<typename std::remove_cvref_t<decltype(bs)>::state_type...>> states(range, {bs.init()...});
+		std::vector<std::size_t> counts(range, 0U);
+
+		const auto add = [&](const std::size_t i)
+		{
+			const auto slot = static_cast<std::size_t>(key_at(i) - lowest);
+			++counts[slot];
+			std::apply([&](auto &...state) { (..., bs.add(state, i)); }, states[slot]);
+		};
+		impl::for_each_selected(selection, add, [&](std::size_t first, const std::size_t last)
+		{
+			for (; first < last; ++first)
+				add(first);
+		});
+
+		result.reserve(static_cast<std::size_t>(std::count_if(std::begin(counts), std::end(counts),
+			[](const std::size_t c) { return c != 0U; })));
+		for (std::size_t k = 0U; k < range; ++k)
+		{
+			if (counts[k] == 0U)
+				continue;
+			result.emplace_back(static_cast<key_type>(lowest + static_cast<std::int64_t>(k)),
+				std::apply([&](const auto &...state) { return results_type{bs.result(state)...}; }, states[k]));
+		}
+		return result;
+	}, bound);
+}
+} // namespace query
+} // namespace soa
+
+#endif // SOA_QUERY_H
@@ -0,0 +1,204 @@
+#ifndef SOA_SHARED_STRUCT_ARRAY_H
+#define SOA_SHARED_STRUCT_ARRAY_H
+
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "fields.h"
+#include "layout.h"
+#include "struct_array.h"
+
+namespace soa
+{
+// struct_array whose copies share their columns until one of them writes to a column, which is
+// then copied on its own (layout::copy_on_write)
+template <typename T, typename Allocator = std::allocator<std::byte>>
+using shared_struct_array = struct_array<T, layout::copy_on_write, Allocator>;
+
+// read-only copy of a shared_struct_array as it was when the snapshot was taken, e.g.
+//
+//   const auto report = soa::snapshot(particles);
+//   particles.column<"x">()[0] = 1.0f; // copies x for particles, report keeps the old one
+//
+// Taking it costs one reference count per column. It has to be taken where the array may be
+// read, i.e. by the writer or while the writer is held off; afterwards the snapshot can be read
+// on any thread while the writer carries on, and releasing it on another thread is fine too.
+//
+// Any access through a non-const array copies the columns it reaches that a snapshot still holds,
+// reads included: whole rows (operator[], front, back, iterators, data()) reach every column,
+// column, columns and project only the named ones. Read through std::as_const(array) to avoid it.
+//
+// Pointers, projections and column ranges taken from the array before the snapshot still point
+// into the columns the snapshot now shares. Writing through them changes the snapshot and races
+// with its readers, so retake them from the array after every snapshot.
+template <typename T, typename Allocator = std::allocator<std::byte>>
+class struct_array_snapshot
+{
+public:
+	using array_type = shared_struct_array<T, Allocator>;
+	using struct_type = T;
+	using allocator_type = Allocator;
+	using value_type = typename array_type::value_type;
+	using size_type = typename array_type::size_type;
+	using difference_type = typename array_type::difference_type;
+	using reference = typename array_type::const_reference;
+	using const_reference = typename array_type::const_reference;
+	using pointer = typename array_type::const_pointer;
+	using const_pointer = typename array_type::const_pointer;
+	using iterator = typename array_type::const_iterator;
+	using const_iterator = typename array_type::const_iterator;
+	using reverse_iterator = typename array_type::const_reverse_iterator;
+	using const_reverse_iterator = typename array_type::const_reverse_iterator;
+
+	struct_array_snapshot() = default;
+
+	explicit struct_array_snapshot(const array_type &array)
+		: rows{array}
+	{
+	}
+
+	// the rows as a const struct_array for the algorithms taking one
+	[[nodiscard]]
+	auto values() const noexcept -> const array_type&
+	{
+		return rows;
+	}
+
+	[[nodiscard]]
+	auto operator[](const size_type pos) const -> const_reference
+	{
+		return rows[pos];
+	}
+
+	[[nodiscard]]
+	auto front() const -> const_reference
+	{
+		return rows.front();
+	}
+
+	[[nodiscard]]
+	auto back() const -> const_reference
+	{
+		return rows.back();
+	}
+
+	[[nodiscard]]
+	auto data() const noexcept -> const_pointer
+	{
+		return rows.data();
+	}
+
+	[[nodiscard]]
+	auto begin() const noexcept -> const_iterator
+	{
+		return std::cbegin(rows);
+	}
+
+	[[nodiscard]]
+	auto cbegin() const noexcept -> const_iterator
+	{
+		return std::cbegin(rows);
+	}
+
+	[[nodiscard]]
+	auto end() const noexcept -> const_iterator
+	{
+		return std::cend(rows);
+	}
+
+	[[nodiscard]]
+	auto cend() const noexcept -> const_iterator
+	{
+		return std::cend(rows);
+	}
+
+	[[nodiscard]]
+	auto rbegin() const noexcept -> const_reverse_iterator
+	{
+		return std::crbegin(rows);
+	}
+
+	[[nodiscard]]
+	auto crbegin() const noexcept -> const_reverse_iterator
+	{
+		return std::crbegin(rows);
+	}
+
+	[[nodiscard]]
+	auto rend() const noexcept -> const_reverse_iterator
+	{
+		return std::crend(rows);
+	}
+
+	[[nodiscard]]
+	auto crend() const noexcept -> const_reverse_iterator
+	{
+		return std::crend(rows);
+	}
+
+	template <std::size_t... Js>
+	[[nodiscard]]
+	auto project() const noexcept
+	{
+		return rows.template project<Js...>();
+	}
+
+	template <auto... Members>
+	requires (... && std::is_same_v<T, typename member_index<Members>::class_type>)
+	[[nodiscard]]
+	auto columns() const noexcept
+	{
+		return rows.template columns<Members...>();
+	}
+
+	template <fixed_string... Names>
+	[[nodiscard]]
+	auto columns() const noexcept
+	{
+		return rows.template columns<Names...>();
+	}
+
+	template <auto Member>
+	requires std::is_same_v<T, typename member_index<Member>::class_type>
+	[[nodiscard]]
+	auto column() const noexcept -> decltype(auto)
+	{
+		return rows.template column<Member>();
+	}
+
+	template <fixed_string Name>
+	[[nodiscard]]
+	auto column() const noexcept -> decltype(auto)
+	{
+		return rows.template column<Name>();
+	}
+
+	[[nodiscard]]
+	bool empty() const noexcept
+	{
+		return std::empty(rows);
+	}
+
+	[[nodiscard]]
+	auto size() const noexcept -> size_type
+	{
+		return std::size(rows);
+	}
+
+private:
+	array_type rows;
+};
+
+template <typename T, typename I, typename S>
+requires std::is_same_v<impl::struct_array_impl<T, I, S>, shared_struct_array<T, typename S::allocator_type>>
+[[nodiscard]]
+auto snapshot(const impl::struct_array_impl<T, I, S> &array) -> struct_array_snapshot<T, typename S::allocator_type>
+{
+	return struct_array_snapshot<T, typename S::allocator_type>{array};
+}
+} // namespace soa
+
+#endif // SOA_SHARED_STRUCT_ARRAY_H
@@ -0,0 +1,304 @@
+#ifndef SOA_SIMD_H
+#define SOA_SIMD_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if !defined(SOA_NO_SIMD) && __has_include(<experimental/simd>)
+#include <experimental/simd>
+#define SOA_HAS_SIMD 1
+#else
+#define SOA_HAS_SIMD 0
+#endif
+
+#include "bitmask.h"
+
+// Column kernels over anything with data() and size() returning contiguous columns, i.e.
+// struct_array (both layouts) and projections. Lambdas are called with native SIMD vectors for
+// the aligned body and with plain values for the unaligned head and the tail, so they have to be
+// generic. Without <experimental/simd> (or with SOA_NO_SIMD) everything runs the scalar loop.
+namespace soa
+{
+namespace simd
+{
+namespace impl
+{
+template <std::size_t I, typename A>
+using element_t = std::remove_cv_t<std::remove_pointer_t<std::tuple_element_t<I, decltype(std::declval<A &>().data())>>>;
+
+#if SOA_HAS_SIMD
+namespace stdx = std::experimental;
+
+template <typename... Ts>
+inline static constexpr bool vectorizable_v = (... && (std::is_arithmetic_v<Ts> && !std::is_same_v<Ts, bool>));
+
+// all columns of a kernel share the lane count of T; mixed column types use fixed_size vectors
+// because only those convert into each other implicitly
+template <typename U, typename T, typename... Ts>
+using vector_t = std::conditional_t<(... && std::is_same_v<T, Ts>), stdx::native_simd<U>,
+                                    stdx::fixed_size_simd<U, stdx::native_simd<T>::size()>>;
+
+template <typename V, typename T>
+[[nodiscard]]
+bool is_aligned(const T *const p) noexcept
+{
+	return reinterpret_cast<std::uintptr_t>(p) % stdx::memory_alignment_v<V> == 0U;
+}
+
+// scalar iterations needed until p is aligned for V, clamped to n
+template <typename V, typename T>
+[[nodiscard]]
+auto head_of(const T *const p, const std::size_t n) noexcept -> std::size_t
+{
+	constexpr auto alignment = stdx::memory_alignment_v<V>;
+	const auto misalignment = reinterpret_cast<std::uintptr_t>(p) % alignment;
+	if (misalignment == 0U || misalignment % sizeof(T) != 0U)
+		return 0U;
+	return std::min(n, (alignment - misalignment) / sizeof(T));
+}
+
+// runs body over full vectors starting at i, with vector_aligned loads if every pointer allows it
+template <typename V, typename... Ps, typename F>
+void for_each_vector(std::size_t &i, const std::size_t n, F &&body, const Ps *...ps)
+{
+	constexpr auto W = V::size();
+	if ((... && is_aligned<vector_t<Ps, typename V::value_type, Ps...>>(ps + i)))
+		for (; i + W <= n; i += W)
+			body(i, stdx::vector_aligned);
+	else
+		for (; i + W <= n; i += W)
+			body(i, stdx::element_aligned);
+}
+#else
+template <typename... Ts>
+inline static constexpr bool vectorizable_v = false;
+#endif
+} // namespace impl
+
+// column Out = f(column In...) element-wise
+template <std::size_t Out, std::size_t... In, typename A, typename F>
+void transform(A &&array, F &&f)
+{
+	const auto n = std::size(array);
+	const auto columns = array.data();
+	auto *const out = std::get<Out>(columns);
+	std::size_t i = 0U;
+
+#if SOA_HAS_SIMD
+	using T = impl::element_t<Out, A>;
+
+	if constexpr (impl::vectorizable_v<T, impl::element_t<In, A>...>)
+	{
+		using V = impl::stdx::native_simd<T>;
+
+		for (const auto head = impl::head_of<V>(out, n); i < head; ++i)
+			out[i] = f(std::get<In>(columns)[i]...);
+
+		impl::for_each_vector<V>(i, n, [&](const std::size_t j, auto flags)
+		{
+			const auto result = f(impl::vector_t<impl::element_t<In, A>, T, T, impl::element_t<In, A>...>{
+				std::get<In>(columns) + j, flags
+			}...);
+			impl::stdx::static_simd_cast<V>(result).copy_to(out + j, flags);
+		}, out, std::get<In>(columns)...);
+	}
+#endif
+
+	for (; i < n; ++i)
+		out[i] = f(std::get<In>(columns)[i]...);
+}
+
+// reduces column I with op, init is the identity of op; vectors are folded with op and reduced
+// horizontally with hop
+template <std::size_t I, typename A, typename T, typename Op, typename HOp>
+[[nodiscard]]
+auto reduce(const A &array, const T init, Op &&op, [[maybe_unused]] HOp &&hop) -> T
+{
+	const auto n = std::size(array);
+	const auto *const in = std::get<I>(array.data());
+	auto result = init;
+	std::size_t i = 0U;
+
+#if SOA_HAS_SIMD
+	if constexpr (impl::vectorizable_v<T, impl::element_t<I, A>>)
+	{
+		using E = impl::element_t<I, A>;
+		using V = impl::vector_t<T, E, T, E>;
+		using W = impl::vector_t<E, E, T, E>;
+
+		for (const auto head = impl::head_of<W>(in, n); i < head; ++i)
+			result = op(result, static_cast<T>(in[i]));
+
+		if (i + W::size() <= n)
+		{
+			V accumulator{init};
+			impl::for_each_vector<W>(i, n, [&](const std::size_t j, auto flags)
+			{
+				accumulator = op(accumulator, impl::stdx::static_simd_cast<V>(W{in + j, flags}));
+			}, in);
+			result = op(result, hop(accumulator));
+		}
+	}
+#endif
+
+	for (; i < n; ++i)
+		result = op(result, static_cast<T>(in[i]));
+	return result;
+}
+
+template <std::size_t I, typename A>
+[[nodiscard]]
+auto sum(const A &array) -> impl::element_t<I, A>
+{
+	using T = impl::element_t<I, A>;
+	return reduce<I>(array, T{}, std::plus<>{}, [](const auto &v) { return reduce(v); });
+}
+
+// smallest element of column I, std::numeric_limits<T>::max() if empty
+template <std::size_t I, typename A>
+[[nodiscard]]
+auto min(const A &array) -> impl::element_t<I, A>
+{
+	using T = impl::element_t<I, A>;
+	using std::min;
+	return reduce<I>(array, std::numeric_limits<T>::max(), [](const auto &l, const auto &r) { return min(l, r); },
+	                 [](const auto &v) { return hmin(v); });
+}
+
+// largest element of column I, std::numeric_limits<T>::lowest() if empty
+template <std::size_t I, typename A>
+[[nodiscard]]
+auto max(const A &array) -> impl::element_t<I, A>
+{
+	using T = impl::element_t<I, A>;
+	using std::max;
+	return reduce<I>(array, std::numeric_limits<T>::lowest(), [](const auto &l, const auto &r) { return max(l, r); },
+	                 [](const auto &v) { return hmax(v); });
+}
+
+// sum of column I times column J
+template <std::size_t I, std::size_t J, typename A>
+[[nodiscard]]
+auto dot(const A &array) -> std::common_type_t<impl::element_t<I, A>, impl::element_t<J, A>>
+{
+	using T = std::common_type_t<impl::element_t<I, A>, impl::element_t<J, A>>;
+
+	const auto n = std::size(array);
+	const auto columns = array.data();
+	const auto *const lhs = std::get<I>(columns);
+	const auto *const rhs = std::get<J>(columns);
+	T result{};
+	std::size_t i = 0U;
+
+#if SOA_HAS_SIMD
+	if constexpr (impl::vectorizable_v<T, impl::element_t<I, A>, impl::element_t<J, A>>)
+	{
+		using V = impl::stdx::native_simd<T>;
+		using L = impl::vector_t<impl::element_t<I, A>, T, T, impl::element_t<I, A>, impl::element_t<J, A>>;
+		using R = impl::vector_t<impl::element_t<J, A>, T, T, impl::element_t<I, A>, impl::element_t<J, A>>;
+
+		for (const auto head = impl::head_of<V>(lhs, n); i < head; ++i)
+			result += static_cast<T>(lhs[i]) * static_cast<T>(rhs[i]);
+
+		V accumulator{};
+		impl::for_each_vector<V>(i, n, [&](const std::size_t j, auto flags)
+		{
+			accumulator += impl::stdx::static_simd_cast<V>(L{lhs + j, flags}) * impl::stdx::static_simd_cast<V>(R{rhs + j, flags});
+		}, lhs, rhs);
+		result += impl::stdx::reduce(accumulator);
+	}
+#endif
+
+	for (; i < n; ++i)
+		result += static_cast<T>(lhs[i]) * static_cast<T>(rhs[i]);
+	return result;
+}
+
+// bit i is set if pred(column In[i]...) holds, pred returns a simd_mask for vector arguments
+template <std::size_t... In, typename A, typename F>
+[[nodiscard]]
+auto mask(const A &array, F &&pred) -> bitmask
+{
+	const auto n = std::size(array);
+	const auto columns = array.data();
+	bitmask result{n};
+	std::size_t i = 0U;
+
+#if SOA_HAS_SIMD
+	if constexpr (impl::vectorizable_v<impl::element_t<In, A>...>)
+	{
+		using T = std::tuple_element_t<0U, std::tuple<impl::element_t<In, A>...>>;
+		using V = impl::stdx::native_simd<T>;
+
+		for (const auto head = impl::head_of<V>(std::get<0U>(std::tuple{std::get<In>(columns)...}), n); i < head; ++i)
+			result.set(i, pred(std::get<In>(columns)[i]...));
+
+		auto words = result.words();
+		impl::for_each_vector<V>(i, n, [&](const std::size_t j, auto flags)
+		{
+			const auto m = pred(impl::vector_t<impl::element_t<In, A>, T, impl::element_t<In, A>...>{
+				std::get<In>(columns) + j, flags
+			}...);
+			bool flags_of[V::size()];
+			m.copy_to(flags_of, impl::stdx::element_aligned);
+			auto lanes = bitmask::word_type{0U};
+			for (std::size_t k = 0U; k < V::size(); ++k)
+				lanes |= bitmask::word_type{flags_of[k]} << k;
+
+			const auto offset = j % bitmask::word_bits;
+			words[j / bitmask::word_bits] |= lanes << offset;
+			if (offset + V::size() > bitmask::word_bits)
+				words[j / bitmask::word_bits + 1U] |= lanes >> (bitmask::word_bits - offset);
+		}, std::get<In>(columns)...);
+	}
+#endif
+
+	for (; i < n; ++i)
+		result.set(i, pred(std::get<In>(columns)[i]...));
+	return result;
+}
+
+// number of rows for which pred(column In[i]...) holds
+template <std::size_t... In, typename A, typename F>
+[[nodiscard]]
+auto count_if(const A &array, F &&pred) -> std::size_t
+{
+	const auto n = std::size(array);
+	const auto columns = array.data();
+	std::size_t result = 0U;
+	std::size_t i = 0U;
+
+#if SOA_HAS_SIMD
+	if constexpr (impl::vectorizable_v<impl::element_t<In, A>...>)
+	{
+		using T = std::tuple_element_t<0U, std::tuple<impl::element_t<In, A>...>>;
+		using V = impl::stdx::native_simd<T>;
+
+		for (const auto head = impl::head_of<V>(std::get<0U>(std::tuple{std::get<In>(columns)...}), n); i < head; ++i)
+			result += pred(std::get<In>(columns)[i]...) ? 1U : 0U;
+
+		impl::for_each_vector<V>(i, n, [&](const std::size_t j, auto flags)
+		{
+			const auto m = pred(impl::vector_t<impl::element_t<In, A>, T, impl::element_t<In, A>...>{
+				std::get<In>(columns) + j, flags
+			}...);
+			result += static_cast<std::size_t>(impl::stdx::popcount(m));
+		}, std::get<In>(columns)...);
+	}
+#endif
+
+	for (; i < n; ++i)
+		result += pred(std::get<In>(columns)[i]...) ? 1U : 0U;
+	return result;
+}
+} // namespace simd
+} // namespace soa
+
+#endif // SOA_SIMD_H
@@ -0,0 +1,189 @@
+#ifndef SOA_SORT_H
+#define SOA_SORT_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel.h"
+
+// Key sorts: only the key column (or the projected keys) is sorted together with a row index,
+// afterwards every column is permuted once. Integral and floating point keys compared with
+// std::less / std::greater go through an LSD radix sort, everything else through std::sort or
+// std::stable_sort on the index.
+namespace soa
+{
+namespace impl
+{
+// below this many rows a comparison sort beats the radix passes
+inline static constexpr std::size_t radix_sort_threshold = 256U;
+
+template <typename K>
+inline static constexpr bool radix_sortable_v = (std::is_integral_v<K> && !std::is_same_v<K, bool>)
+	|| (std::is_floating_point_v<K> && std::numeric_limits<K>::is_iec559 && (sizeof(K) == 4U || sizeof(K) == 8U));
+
+template <typename Compare>
+inline static constexpr bool ascending_v = std::is_same_v<Compare, std::less<>>
+	|| std::is_same_v<Compare, std::ranges::less>;
+
+template <typename Compare>
+inline static constexpr bool descending_v = std::is_same_v<Compare, std::greater<>>
+	|| std::is_same_v<Compare, std::ranges::greater>;
+
+template <typename K>
+using radix_t = std::conditional_t<sizeof(K) == 1U, std::uint8_t,
+	std::conditional_t<sizeof(K) == 2U, std::uint16_t,
+		std::conditional_t<sizeof(K) == 4U, std::uint32_t, std::uint64_t>>>;
+
+// maps a key to an unsigned integer with the same order; -0.0 and +0.0 compare equal, so both
+// get the key of +0.0 to keep equal keys in their order
+template <typename K>
+[[nodiscard]]
+constexpr auto radix_key(const K key) noexcept -> radix_t<K>
+{
+	using U = radix_t<K>;
+	constexpr auto sign = U{1U} << (sizeof(K) * 8U - 1U);
+
+	const auto bits = std::bit_cast<U>(std::is_floating_point_v<K> && key == K{} ? K{} : key);
+	if constexpr (std::is_floating_point_v<K>)
+		return (bits & sign) != 0U ? static_cast<U>(~bits) : static_cast<U>(bits | sign);
+	else if constexpr (std::is_signed_v<K>)
+		return static_cast<U>(bits ^ sign);
+	else
+		return bits;
+}
+
+// stable LSD radix sort of the row index by keys, one byte per pass, constant bytes are skipped
+template <bool Descending, typename K>
+[[nodiscard]]
+auto radix_sort(const K *const keys, const std::size_t n) -> std::vector<std::size_t>
+{
+	using U = radix_t<K>;
+	constexpr auto passes = sizeof(U);
+
+	std::vector<U> key(n);
+	std::transform(keys, keys + n, std::begin(key), [](const K k) noexcept
+	{
+		const auto u = radix_key(k);
+		return Descending ? static_cast<U>(~u) : u;
+	});
+
+	std::array<std::array<std::size_t, 256U>, passes> histograms{};
+	for (const auto u : key)
+		for (std::size_t pass = 0U; pass < passes; ++pass)
+			++histograms[pass][(u >> (pass * 8U)) & 0xFFU];
+
+	std::vector<std::size_t> index(n);
+	std::iota(std::begin(index), std::end(index), std::size_t{0U});
+
+	std::vector<U> key_buffer(n);
+	std::vector<std::size_t> index_buffer(n);
+
+	for (std::size_t pass = 0U; pass < passes; ++pass)
+	{
+		auto &histogram = histograms[pass];
+		if (std::find(std::begin(histogram), std::end(histogram), n) != std::end(histogram))
+			continue;
+
+		std::exclusive_scan(std::begin(histogram), std::end(histogram), std::begin(histogram), std::size_t{0U});
+		for (std::size_t i = 0U; i < n; ++i)
+		{
+			const auto slot = histogram[(key[i] >> (pass * 8U)) & 0xFFU]++;
+			key_buffer[slot] = key[i];
+			index_buffer[slot] = index[i];
+		}
+		key.swap(key_buffer);
+		index.swap(index_buffer);
+	}
+
+	return index;
+}
+
+// row order that sorts keys[0, n) by comp
+template <bool Stable, typename K, typename Compare>
+[[nodiscard]]
+auto sort_permutation(const K *const keys, const std::size_t n, Compare &comp) -> std::vector<std::size_t>
+{
+	if constexpr (radix_sortable_v<K> && (ascending_v<Compare> || descending_v<Compare>))
+	{
+		if (n >= radix_sort_threshold)
+			return radix_sort<descending_v<Compare>>(keys, n);
+	}
+
+	std::vector<std::size_t> perm(n);
+	std::iota(std::begin(perm), std::end(perm), std::size_t{0U});
+
+	const auto less = [&](const std::size_t l, const std::size_t r) { return comp(keys[l], keys[r]); };
+	if constexpr (Stable)
+		std::stable_sort(std::begin(perm), std::end(perm), less);
+	else
+		std::sort(std::begin(perm), std::end(perm), less);
+	return perm;
+}
+
+template <bool Stable, std::size_t I, typename A, typename Compare>
+void sort_by(A &array, Compare &comp)
+{
+	const auto perm = sort_permutation<Stable>(std::get<I>(std::as_const(array).data()), std::size(array), comp);
+	apply_permutation(std::execution::seq, array, perm,
+	                  std::make_index_sequence<std::tuple_size_v<columns_t<A>>>{});
+}
+
+template <bool Stable, typename A, typename Projection, typename Compare>
+void sort_by(A &array, Projection &proj, Compare &comp)
+{
+	using K = std::remove_cvref_t<std::invoke_result_t<Projection &, decltype(std::as_const(array)[0U])>>;
+
+	std::vector<K> keys;
+	keys.reserve(std::size(array));
+	for (std::size_t i = 0U; i < std::size(array); ++i)
+		keys.push_back(std::invoke(proj, std::as_const(array)[i]));
+
+	const auto perm = sort_permutation<Stable>(std::data(keys), std::size(keys), comp);
+	apply_permutation(std::execution::seq, array, perm,
+	                  std::make_index_sequence<std::tuple_size_v<columns_t<A>>>{});
+}
+} // namespace impl
+
+// sorts the rows by column I
+template <std::size_t I, typename A, typename Compare = std::less<>>
+void sort_by(A &&array, Compare comp = {})
+{
+	impl::sort_by<false, I>(array, comp);
+}
+
+// sorts the rows by column I, rows with equal keys keep their order
+template <std::size_t I, typename A, typename Compare = std::less<>>
+void stable_sort_by(A &&array, Compare comp = {})
+{
+	impl::sort_by<true, I>(array, comp);
+}
+
+// sorts the rows by proj(const_reference), the keys are computed once per row
+template <typename A, typename Projection, typename Compare = std::less<>>
+requires std::invocable<Projection &, decltype(std::as_const(std::declval<A &>())[0U])>
+void sort_by(A &&array, Projection proj, Compare comp = {})
+{
+	impl::sort_by<false>(array, proj, comp);
+}
+
+template <typename A, typename Projection, typename Compare = std::less<>>
+requires std::invocable<Projection &, decltype(std::as_const(std::declval<A &>())[0U])>
+void stable_sort_by(A &&array, Projection proj, Compare comp = {})
+{
+	impl::sort_by<true>(array, proj, comp);
+}
+} // namespace soa
+
+#endif // SOA_SORT_H
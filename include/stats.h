@@ -0,0 +1,296 @@
+#ifndef SOA_STATS_H
+#define SOA_STATS_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "fields.h"
+
+// Opt-in container statistics. Built with SOA_STATS=1 the storage of every struct_array carries a
+// recorder that counts reallocations and the bytes they relocate per column, the elements insert
+// and erase shift, the peak size, capacity and capacity-to-size ratio, and how often every column
+// is handed out through project, column or data. SOA_STATS_SAMPLE_RATE=N additionally counts one
+// in N row dereferences of the container iterators (and operator[], front, back) on each thread,
+// credited to the array dereferenced. A row dereference reaches every column, so that figure is
+// per container; which columns a loop really needs shows in the per column view counts.
+// soa::stats_of(array) takes a snapshot and soa::to_json renders it. Without SOA_STATS the storage
+// types are unchanged and every hook is an empty inline function.
+#ifndef SOA_STATS
+#define SOA_STATS 0
+#endif
+
+#ifndef SOA_STATS_SAMPLE_RATE
+#define SOA_STATS_SAMPLE_RATE 0
+#endif
+
+namespace soa
+{
+struct column_stats
+{
+	std::string_view name; // empty unless the struct has SOA_FIELDS
+	std::size_t element_size = 0U;
+	std::uint64_t reallocations = 0U;
+	std::uint64_t bytes_moved = 0U;   // relocated by reallocations
+	std::uint64_t element_moves = 0U; // shifted by insert and erase
+	std::uint64_t views = 0U;         // project, column and data calls that included the column
+};
+
+struct container_stats
+{
+	std::vector<column_stats> columns;
+	std::size_t size = 0U;
+	std::size_t capacity = 0U;
+	std::size_t peak_size = 0U;
+	std::size_t peak_capacity = 0U;
+	double peak_capacity_ratio = 0.0;   // largest capacity / size seen after a mutation of a non-empty container
+	std::uint64_t sampled_accesses = 0U; // row dereferences, estimated from the samples
+};
+
+namespace impl
+{
+inline static constexpr std::uint32_t stats_sample_rate = SOA_STATS_SAMPLE_RATE;
+
+// row dereferences left until the next sample on this thread, shared by all arrays
+inline thread_local std::uint32_t stats_countdown = stats_sample_rate;
+
+// lives in the storage so the container iterators, which only know the storage, can reach it;
+// copies start from zero because the counters describe one container object
+template <std::size_t N>
+struct stats_recorder
+{
+	std::array<std::uint64_t, N> bytes_moved{};
+	std::uint64_t reallocations = 0U;
+	std::uint64_t element_moves = 0U;
+	std::size_t peak_size = 0U;
+	std::size_t peak_capacity = 0U;
+	double peak_capacity_ratio = 0.0;
+	mutable std::array<std::atomic<std::uint64_t>, N> views{};
+	mutable std::atomic<std::uint64_t> samples{0U};
+
+	stats_recorder() = default;
+
+	stats_recorder(const stats_recorder &) noexcept
+	{
+	}
+
+	auto operator=(const stats_recorder &) noexcept -> stats_recorder&
+	{
+		return *this;
+	}
+
+	// a mutation took the container from (size, capacity) to (new_size, new_capacity); relocating
+	// storages move the old rows when the capacity changes
+	void mutated(const std::size_t size, const std::size_t capacity, const std::size_t new_size,
+	             const std::size_t new_capacity, const bool relocating, const std::array<std::size_t, N> &sizes) noexcept
+	{
+		if (relocating && new_capacity != capacity)
+		{
+			++reallocations;
+			const auto rows = std::min(size, new_size);
+			for (std::size_t i = 0U; i < N; ++i)
+				bytes_moved[i] += rows * sizes[i];
+		}
+
+		peak_size = std::max(peak_size, new_size);
+		peak_capacity = std::max(peak_capacity, new_capacity);
+		if (new_size != 0U)
+			peak_capacity_ratio = std::max(peak_capacity_ratio, static_cast<double>(new_capacity) / static_cast<double>(new_size));
+	}
+
+	void viewed(const std::size_t column) const noexcept
+	{
+		views[column].fetch_add(1U, std::memory_order_relaxed);
+	}
+
+	void accessed() const noexcept
+	{
+		// every N-th dereference a thread makes is a sample of the array it reached, so the array is
+		// only written when a sample fires and still gets one sample per N of its own dereferences
+		// on average
+		if constexpr (stats_sample_rate != 0U)
+		{
+			if (--stats_countdown == 0U)
+			{
+				stats_countdown = stats_sample_rate;
+				samples.fetch_add(1U, std::memory_order_relaxed);
+			}
+		}
+	}
+};
+
+// storage S with a recorder attached, what storage_t gives with SOA_STATS
+template <typename S, std::size_t N>
+struct instrumented_storage : S
+{
+	using S::S;
+
+	instrumented_storage() = default;
+
+	stats_recorder<N> stats;
+};
+
+template <typename S>
+inline static constexpr bool instrumented_v = requires(const S &storage) { storage.stats; };
+
+template <typename S, std::size_t N>
+using instrumented_t = std::conditional_t<SOA_STATS != 0, instrumented_storage<S, N>, S>;
+
+template <std::size_t... Js, typename S>
+void record_views(const S &storage) noexcept
+{
+	if constexpr (instrumented_v<S>)
+		(..., storage.stats.viewed(Js));
+}
+
+template <typename S>
+void record_access(const S &storage) noexcept
+{
+	if constexpr (instrumented_v<S>)
+		storage.stats.accessed();
+}
+
+// compares size and capacity of A before and after one mutation; empty without a recorder
+template <typename A, bool = instrumented_v<typename A::storage_type>>
+struct mutation_tracker
+{
+	explicit mutation_tracker(A &) noexcept
+	{
+	}
+
+	void moved(std::size_t) noexcept
+	{
+	}
+};
+
+template <typename A>
+struct mutation_tracker<A, true>
+{
+	A &array;
+	std::size_t size = std::size(array);
+	std::size_t capacity = array.capacity();
+
+	explicit mutation_tracker(A &array) noexcept
+		: array{array}
+	{
+	}
+
+	mutation_tracker(const mutation_tracker &) = delete;
+
+	~mutation_tracker()
+	{
+		array.components.stats.mutated(size, capacity, std::size(array), array.capacity(),
+		                               !requires { A::storage_type::chunk_size; }, element_sizes());
+	}
+
+	auto operator=(const mutation_tracker &) -> mutation_tracker& = delete;
+
+	// elements of every column shifted by insert or erase
+	void moved(const std::size_t elements) noexcept
+	{
+		array.components.stats.element_moves += elements;
+	}
+
+private:
+	[[nodiscard]]
+	static constexpr auto element_sizes() noexcept
+	{
+		return []<typename... Ts>(std::type_identity<std::tuple<Ts...>>)
+		{
+			return std::array<std::size_t, sizeof...(Ts)>{sizeof(Ts)...};
+		}(std::type_identity<typename A::value_type>{});
+	}
+};
+
+inline void append_json(std::string &out, const std::string_view key, const std::uint64_t value)
+{
+	char buffer[24];
+	const auto end = std::to_chars(std::begin(buffer), std::end(buffer), value).ptr;
+	out.append("\"").append(key).append("\":").append(buffer, end);
+}
+
+inline void append_json(std::string &out, const std::string_view key, const double value)
+{
+	char buffer[32];
+	const auto end = std::to_chars(std::begin(buffer), std::end(buffer), value).ptr;
+	out.append("\"").append(key).append("\":").append(buffer, end);
+}
+} // namespace impl
+
+// snapshot of the counters of array, which has to be built with SOA_STATS
+template <typename A>
+[[nodiscard]]
+auto stats_of(const A &array) -> container_stats
+{
+	using S = typename A::storage_type;
+	static_assert(impl::instrumented_v<S>, "container statistics need SOA_STATS");
+
+	const auto &recorder = array.components.stats;
+	container_stats result{};
+	[&]<typename... Ts>(std::type_identity<std::tuple<Ts...>>)
+	{
+		const std::array<std::size_t, sizeof...(Ts)> sizes{sizeof(Ts)...};
+		const auto &names = fields<typename A::struct_type>::names;
+		for (std::size_t i = 0U; i < sizeof...(Ts); ++i)
+			result.columns.push_back({
+				names[i], sizes[i], recorder.reallocations, recorder.bytes_moved[i], recorder.element_moves,
+				recorder.views[i].load(std::memory_order_relaxed)
+			});
+	}(std::type_identity<typename A::value_type>{});
+
+	result.size = std::size(array);
+	result.capacity = array.capacity();
+	result.peak_size = recorder.peak_size;
+	result.peak_capacity = recorder.peak_capacity;
+	result.peak_capacity_ratio = recorder.peak_capacity_ratio;
+	result.sampled_accesses = recorder.samples.load(std::memory_order_relaxed) * impl::stats_sample_rate;
+	return result;
+}
+
+// one JSON object, columns as an array in column order
+[[nodiscard]]
+inline auto to_json(const container_stats &stats) -> std::string
+{
+	std::string out{"{"};
+	impl::append_json(out, "size", std::uint64_t{stats.size});
+	out += ',';
+	impl::append_json(out, "capacity", std::uint64_t{stats.capacity});
+	out += ',';
+	impl::append_json(out, "peak_size", std::uint64_t{stats.peak_size});
+	out += ',';
+	impl::append_json(out, "peak_capacity", std::uint64_t{stats.peak_capacity});
+	out += ',';
+	impl::append_json(out, "peak_capacity_ratio", stats.peak_capacity_ratio);
+	out += ',';
+	impl::append_json(out, "sampled_accesses", stats.sampled_accesses);
+	out += ",\"columns\":[";
+	for (std::size_t i = 0U; i < std::size(stats.columns); ++i)
+	{
+		const auto &column = stats.columns[i];
+		out.append(i == 0U ? "{" : ",{").append("\"name\":\"").append(column.name).append("\",");
+		impl::append_json(out, "element_size", std::uint64_t{column.element_size});
+		out += ',';
+		impl::append_json(out, "reallocations", column.reallocations);
+		out += ',';
+		impl::append_json(out, "bytes_moved", column.bytes_moved);
+		out += ',';
+		impl::append_json(out, "element_moves", column.element_moves);
+		out += ',';
+		impl::append_json(out, "views", column.views);
+		out += '}';
+	}
+	out += "]}";
+	return out;
+}
+} // namespace soa
+
+#endif // SOA_STATS_H
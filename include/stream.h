@@ -0,0 +1,232 @@
+#ifndef SOA_STREAM_H
+#define SOA_STREAM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "layout.h"
+#include "parallel.h"
+#include "projection.h"
+#include "simd.h"
+
+// Column sweeps for arrays much larger than the last level cache. Rows are processed in tiles
+// whose active columns together fit in tile_bytes (L1 / L2 sized), and while a tile is processed
+// the lines prefetch_rows ahead are prefetched in every column it reads, so many column streams do
+// not depend on the hardware prefetchers keeping up. stream_transform computes a tile into a small
+// buffer and, if the output column is not also an input, writes it with non-temporal stores that
+// bypass the cache instead of first reading every output line. Like the simd kernels these need
+// contiguous columns; the executor overloads split the rows like parallel.h and stream each part.
+namespace soa
+{
+struct stream_options
+{
+	std::size_t tile_bytes = 16384U; // bytes of all active columns per tile
+	std::size_t prefetch_rows = 0U;  // prefetch distance, 0 for one tile ahead
+	bool non_temporal = true;        // stream output-only columns past the cache
+};
+
+namespace impl
+{
+// rw is 1 for lines that will be written
+template <int RW, typename T>
+void prefetch_rows(const T *const column, const std::size_t first, const std::size_t last) noexcept
+{
+#if defined(__GNUC__)
+	const auto *const end = reinterpret_cast<const char *>(column + last);
+	for (auto *line = reinterpret_cast<const char *>(column + first); line < end; line += cache_line_size)
+		__builtin_prefetch(line, RW, 3);
+#else
+	static_cast<void>(column);
+	static_cast<void>(first);
+	static_cast<void>(last);
+#endif
+}
+
+template <typename T>
+inline static constexpr bool streamable_v = std::is_trivially_copyable_v<T>;
+
+// copies n elements to out with non-temporal stores where the hardware has them
+template <typename T>
+void stream_copy(T *const out, const T *const in, const std::size_t n) noexcept
+{
+#if defined(__SSE2__)
+	auto *d = reinterpret_cast<char *>(out);
+	const auto *s = reinterpret_cast<const char *>(in);
+	auto bytes = n * sizeof(T);
+
+	const auto head = std::min(bytes, (16U - reinterpret_cast<std::uintptr_t>(d) % 16U) % 16U);
+	std::memcpy(d, s, head);
+	d += head;
+	s += head;
+	bytes -= head;
+
+	for (; bytes >= 16U; bytes -= 16U, d += 16, s += 16)
+		_mm_stream_si128(reinterpret_cast<__m128i *>(d), _mm_loadu_si128(reinterpret_cast<const __m128i *>(s)));
+	std::memcpy(d, s, bytes);
+#else
+	std::memcpy(out, in, n * sizeof(T));
+#endif
+}
+
+// orders the non-temporal stores of this thread before anything it does afterwards
+inline void stream_fence() noexcept
+{
+#if defined(__SSE2__)
+	_mm_sfence();
+#endif
+}
+
+// tile buffer of a non-temporal transform; fences the stores streamed out of it and frees it
+// however the transform ends, f may throw
+template <typename T>
+struct stream_buffer
+{
+	std::size_t size;
+	T *data = std::allocator<T>{}.allocate(size);
+
+	explicit stream_buffer(const std::size_t size)
+		: size{size}
+	{
+	}
+
+	stream_buffer(const stream_buffer &) = delete;
+
+	~stream_buffer()
+	{
+		stream_fence();
+		std::allocator<T>{}.deallocate(data, size);
+	}
+
+	auto operator=(const stream_buffer &) -> stream_buffer& = delete;
+};
+
+template <typename... Ts>
+[[nodiscard]]
+auto tile_rows(const stream_options &options, std::tuple<Ts *...> columns) noexcept -> std::size_t
+{
+	const auto granularity = rows_per_line(columns);
+	const auto rows = options.tile_bytes / (... + sizeof(Ts));
+	return std::max(granularity, rows / granularity * granularity);
+}
+
+// columns are the pointers array.data() returned for all n rows, taken once so the executor
+// overloads hand every worker the same ones
+template <std::size_t... In, typename C, typename F>
+void stream_for_each(const C &columns, const std::size_t n, const std::size_t first, const std::size_t last, F &f,
+                     const stream_options &options)
+{
+	const auto tile = tile_rows(options, std::tuple{std::get<In>(columns)...});
+	const auto ahead = options.prefetch_rows == 0U ? tile : options.prefetch_rows;
+
+	for (auto begin = first; begin < last; begin += tile)
+	{
+		const auto end = std::min(last, begin + tile);
+		(..., prefetch_rows<std::is_const_v<std::remove_pointer_t<std::tuple_element_t<In, C>>> ? 0 : 1>(
+			std::get<In>(columns), std::min(n, begin + ahead), std::min(n, end + ahead)));
+		for (auto i = begin; i < end; ++i)
+			f(std::get<In>(columns)[i]...);
+	}
+}
+
+template <std::size_t Out, std::size_t... In, typename C, typename F>
+void stream_transform(const C &columns, const std::size_t n, const std::size_t first, const std::size_t last, F &f,
+                      const stream_options &options)
+{
+	using T = std::remove_pointer_t<std::tuple_element_t<Out, C>>;
+	constexpr bool output_only = (... && (In != Out));
+
+	auto *const out = std::get<Out>(columns);
+	const auto tile = tile_rows(options, std::tuple{std::get<In>(columns)..., out});
+	const auto ahead = options.prefetch_rows == 0U ? tile : options.prefetch_rows;
+
+	const auto prefetch = [&](const std::size_t begin, const std::size_t end)
+	{
+		(..., prefetch_rows<0>(std::get<In>(columns), std::min(n, begin + ahead), std::min(n, end + ahead)));
+	};
+
+	if constexpr (output_only && streamable_v<T>)
+	{
+		if (options.non_temporal)
+		{
+			// the tile is computed into an L1 resident buffer by the simd kernel and then streamed out
+			const stream_buffer<T> buffer{tile};
+			for (auto begin = first; begin < last; begin += tile)
+			{
+				const auto end = std::min(last, begin + tile);
+				prefetch(begin, end);
+				[&]<std::size_t... Ks>(std::index_sequence<Ks...>)
+				{
+					using inputs = std::tuple<const std::remove_pointer_t<std::tuple_element_t<In, C>> *..., T *>;
+					simd::transform<sizeof...(In), Ks...>(
+						projection<inputs>{{(std::get<In>(columns) + begin)..., buffer.data}, end - begin}, f);
+				}(std::make_index_sequence<sizeof...(In)>{});
+				stream_copy(out + begin, buffer.data, end - begin);
+			}
+			return;
+		}
+	}
+
+	for (auto begin = first; begin < last; begin += tile)
+	{
+		const auto end = std::min(last, begin + tile);
+		prefetch(begin, end);
+		if constexpr (!output_only)
+			prefetch_rows<1>(out, std::min(n, begin + ahead), std::min(n, end + ahead));
+		simd::transform<Out, In...>(slice(columns, begin, end - begin), f);
+	}
+}
+} // namespace impl
+
+// calls f with the columns In... of every row, tile by tile with software prefetching
+template <std::size_t... In, typename A, typename F>
+requires (sizeof...(In) > 0U)
+void stream_for_each(A &&array, F &&f, const stream_options &options = {})
+{
+	const auto n = std::size(array);
+	impl::stream_for_each<In...>(array.data(), n, 0U, n, f, options);
+}
+
+template <std::size_t... In, executor E, typename A, typename F>
+requires (sizeof...(In) > 0U)
+void stream_for_each(E &&exec, A &&array, F &&f, const stream_options &options = {})
+{
+	const auto columns = array.data();
+	const auto n = std::size(array);
+	impl::for_each_chunk<A>(exec, n, [&](const std::size_t first, const std::size_t last)
+	{
+		impl::stream_for_each<In...>(columns, n, first, last, f, options);
+	});
+}
+
+// column Out = f(column In...) like simd::transform, tile by tile with software prefetching and
+// non-temporal stores into an output-only column
+template <std::size_t Out, std::size_t... In, typename A, typename F>
+void stream_transform(A &&array, F &&f, const stream_options &options = {})
+{
+	const auto n = std::size(array);
+	impl::stream_transform<Out, In...>(array.data(), n, 0U, n, f, options);
+}
+
+template <std::size_t Out, std::size_t... In, executor E, typename A, typename F>
+void stream_transform(E &&exec, A &&array, F &&f, const stream_options &options = {})
+{
+	const auto columns = array.data();
+	const auto n = std::size(array);
+	impl::for_each_chunk(exec, n, std::get<Out>(columns), [&](const std::size_t first, const std::size_t last)
+	{
+		impl::stream_transform<Out, In...>(columns, n, first, last, f, options);
+	});
+}
+} // namespace soa
+
+#endif // SOA_STREAM_H
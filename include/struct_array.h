@@ -1,200 +1,121 @@
 #ifndef SOA_STRUCT_ARRAY_H
 #define SOA_STRUCT_ARRAY_H
 
+#include <algorithm>
 #include <cstddef>
 #include <functional>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 
+#include "fields.h"
+#include "layout.h"
+#include "projection.h"
+#include "struct_array_iterator.h"
 #include "tuple_wrapper.h"
-#include "vectorize.h"
 
 namespace soa
 {
 namespace impl
 {
-template <typename T, typename>
-struct struct_array_impl;
+// AoS input is transposed in blocks of about this size, so the source rows are still cached
+// when the later columns read them
+inline static constexpr std::size_t transpose_block_bytes = 16384U;
 
-template <typename T, std::size_t... Is>
-struct struct_array_impl<T, std::index_sequence<Is...>>
+// iterator over field I of the T objects It refers to
+template <std::size_t I, typename T, typename It>
+struct field_iterator
 {
-	using value_type = typename vectorize<T>::value_type;
-	using size_type = typename vectorize<T>::size_type;
-	using difference_type = typename vectorize<T>::difference_type;
-	using reference = typename vectorize<T>::reference;
-	using const_reference = typename vectorize<T>::const_reference;
-	using pointer = typename vectorize<T>::pointer;
-	using const_pointer = typename vectorize<T>::const_pointer;
-
-	template <typename U>
-	struct struct_array_iterator
-	{
-		using value_type = tuple_wrapper<typename vectorize<T>::value_type>;
-		using difference_type = std::ptrdiff_t;
-		using reference = tuple_wrapper<typename vectorize<T>::reference>;
-		using pointer = typename vectorize<T>::pointer;
-		using iterator_category = std::random_access_iterator_tag;
-
-		U iterators;
-
-		struct_array_iterator() = default;
-		struct_array_iterator(const struct_array_iterator &) = default;
-		struct_array_iterator(struct_array_iterator &&) = default;
-
-		template <typename...Args>
-		requires (sizeof...(Is) == sizeof...(Args)) && (... && std::is_constructible_v<
-			std::tuple_element_t<Is, U>, Args>)
-		struct_array_iterator(Args &&...args)
-			: iterators{std::forward<Args>(args)...}
-		{
-		}
-
-		template <typename V>
-		requires (... && std::is_constructible_v<std::tuple_element_t<Is, U>, std::tuple_element_t<Is, V>>)
-		struct_array_iterator(const struct_array_iterator<V> &that)
-			: iterators{std::get<Is>(that.iterators)...}
-		{
-		}
-
-		~struct_array_iterator() = default;
-
-		auto operator=(const struct_array_iterator &) -> struct_array_iterator& = default;
-		auto operator=(struct_array_iterator &&) -> struct_array_iterator& = default;
-
-		template <typename V>
-		requires (... && std::is_constructible_v<std::tuple_element_t<Is, U>, std::tuple_element_t<Is, V>>)
-		auto operator=(const struct_array_iterator<V> &that) noexcept -> struct_array_iterator&
-		{
-			return *this = struct_array_iterator{that};
-		}
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = std::tuple_element_t<I, to_tuple_t<T>>;
+	using difference_type = std::iter_difference_t<It>;
+	using reference = decltype(std::get<I>(make_tie<T>(*std::declval<const It &>())));
+	using pointer = std::add_pointer_t<reference>;
 
-		[[nodiscard]]
-		auto operator-(const difference_type n) const noexcept -> struct_array_iterator
-		{
-			return {(std::get<Is>(iterators) - n) ...};
-		}
+	It it;
 
-		[[nodiscard]]
-		auto operator-(const struct_array_iterator &that) const noexcept -> difference_type
-		{
-			return std::get<0>(iterators) - std::get<0>(that.iterators);
-		}
-
-		[[nodiscard]]
-		auto operator+=(const difference_type n) noexcept -> struct_array_iterator&
-		{
-			return *this = (*this + n);
-		}
-
-		[[nodiscard]]
-		auto operator-=(const difference_type n) noexcept -> struct_array_iterator&
-		{
-			return *this = (*this - n);
-		}
-
-		auto operator++() noexcept -> struct_array_iterator&
-		{
-			(..., ++std::get<Is>(iterators));
-			return *this;
-		}
-
-		[[nodiscard]]
-		auto operator++(int) const noexcept -> struct_array_iterator
-		{
-			return ++struct_array_iterator{*this};
-		}
-
-		auto operator--() noexcept -> struct_array_iterator&
-		{
-			(..., --std::get<Is>(iterators));
-			return *this;
-		}
-
-		[[nodiscard]]
-		auto operator--(int) -> struct_array_iterator
-		{
-			return --struct_array_iterator{*this};
-		}
-
-		auto operator*() noexcept -> reference
-		{
-			return {std::make_tuple(std::ref(*(std::get<Is>(iterators)))...)};
-		}
-
-		auto operator->() noexcept -> pointer
-		{
-			return {((std::get<Is>(iterators)).operator->())...};
-		}
+	auto operator*() const -> reference
+	{
+		return std::get<I>(make_tie<T>(*it));
+	}
 
-		auto operator[](const difference_type n) noexcept -> reference
-		{
-			return {*(std::get<Is>(iterators) + n)...};
-		}
+	auto operator++() -> field_iterator&
+	{
+		++it;
+		return *this;
+	}
 
-		/* TODO Fix noexcept specification */
-		void swap(struct_array_iterator &that) noexcept
-		{
-			(..., swap(std::get<Is>(iterators), std::get<Is>(that.iterators)));
-		}
+	auto operator++(int) -> field_iterator
+	{
+		auto copy = *this;
+		++it;
+		return copy;
+	}
 
-		[[nodiscard]]
-		bool operator==(const struct_array_iterator &that) const noexcept
-		{
-			return *this - that == 0;
-		}
+	[[nodiscard]]
+	bool operator==(const field_iterator &) const = default;
+};
 
-		[[nodiscard]]
-		bool operator!=(const struct_array_iterator &that) const noexcept
-		{
-			return !(*this == that);
-		}
+template <typename T, typename, typename S>
+struct struct_array_impl;
 
-		[[nodiscard]]
-		bool operator<(const struct_array_iterator &that) const noexcept
-		{
-			return *this - that > 0;
-		}
+template <typename T, std::size_t... Is, typename S>
+struct struct_array_impl<T, std::index_sequence<Is...>, S>
+{
+	using storage_type = S;
+	using struct_type = T;
+	using value_type = typename S::value_type;
+	using allocator_type = typename S::allocator_type;
+	using size_type = typename S::size_type;
+	using difference_type = typename S::difference_type;
+	using reference = typename S::reference;
+	using const_reference = typename S::const_reference;
+	using pointer = typename S::pointer;
+	using const_pointer = typename S::const_pointer;
+
+	using iterator = struct_array_index_iterator<S, std::index_sequence<Is...>>;
+	using const_iterator = struct_array_index_iterator<const S, std::index_sequence<Is...>>;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	S components;
 
-		[[nodiscard]]
-		bool operator>(const struct_array_iterator &that) const noexcept
-		{
-			return that < *this;
-		}
+private:
+	// records the mutation it spans in the statistics of an instrumented storage (stats.h)
+	using tracker = impl::mutation_tracker<struct_array_impl>;
 
-		[[nodiscard]]
-		bool operator<=(const struct_array_iterator &that) const noexcept
-		{
-			return !(*this > that);
-		}
+	// writable columns of a copy on write storage may have to be copied first
+	template <std::size_t... Js>
+	static constexpr bool nothrow_columns = (... && noexcept(std::declval<S &>().template column<Js>()));
 
-		[[nodiscard]]
-		bool operator>=(const struct_array_iterator &that) const noexcept
-		{
-			return !(*this < that);
-		}
+public:
+	struct_array_impl() = default;
 
-		// friend hack to allow definition inside nested class
-		friend auto operator+(const struct_array_iterator &it,
-		                      const difference_type n) noexcept -> struct_array_iterator
-		{
-			return {(std::get<Is>(it.iterators) + n)...};
-		}
+	explicit struct_array_impl(const allocator_type &alloc)
+		: components{alloc}
+	{
+	}
 
-		// friend hack to allow definition inside nested class
-		friend auto operator+(const difference_type n,
-		                      const struct_array_iterator &it) noexcept -> struct_array_iterator
-		{
-			return it + n;
-		}
-	};
+	struct_array_impl(const struct_array_impl &that, const allocator_type &alloc)
+		: components{that.components, alloc}
+	{
+	}
 
-	using iterator = struct_array_iterator<typename vectorize<T>::iterator>;
-	using const_iterator = struct_array_iterator<typename vectorize<T>::const_iterator>;
-	using reverse_iterator = struct_array_iterator<typename vectorize<T>::reverse_iterator>;
-	using const_reverse_iterator = struct_array_iterator<typename vectorize<T>::const_reverse_iterator>;
+	struct_array_impl(struct_array_impl &&that, const allocator_type &alloc)
+		: components{std::move(that.components), alloc}
+	{
+	}
 
-	vectorize_t<T> components;
+	[[nodiscard]]
+	auto get_allocator() const noexcept -> allocator_type
+	{
+		return components.get_allocator();
+	}
 
 	auto operator[](const std::size_t pos) -> reference
 	{
@@ -228,137 +149,223 @@ struct struct_array_impl<T, std::index_sequence<Is...>>
 		return *(cend() - 1);
 	}
 
-	auto data() noexcept -> pointer
+	auto data() noexcept(nothrow_columns<Is...>) -> pointer
 	{
-		return {std::data(std::get<Is>(components))...};
+		impl::record_views<Is...>(components);
+		return {std::data(components.template column<Is>())...};
 	}
 
 	[[nodiscard]]
-	auto data() const noexcept -> pointer
+	auto data() const noexcept -> const_pointer
 	{
-		return {std::data(std::get<Is>(components))...};
+		impl::record_views<Is...>(components);
+		return {std::data(components.template column<Is>())...};
 	}
 
 	auto begin() noexcept -> iterator
 	{
-		return {std::begin(std::get<Is>(components))...};
+		return {&components, 0};
 	}
 
 	[[nodiscard]]
-	auto begin() const noexcept -> iterator
+	auto begin() const noexcept -> const_iterator
 	{
-		return {std::begin(std::get<Is>(components))...};
+		return cbegin();
 	}
 
 	[[nodiscard]]
 	auto cbegin() const noexcept -> const_iterator
 	{
-		return {std::cbegin(std::get<Is>(components))...};
+		return {&components, 0};
 	}
 
 	auto end() noexcept -> iterator
 	{
-		return {std::end(std::get<Is>(components))...};
+		return {&components, static_cast<difference_type>(size())};
 	}
 
 	[[nodiscard]]
-	auto end() const noexcept -> iterator
+	auto end() const noexcept -> const_iterator
 	{
-		return {std::end(std::get<Is>(components))...};
+		return cend();
 	}
 
 	[[nodiscard]]
 	auto cend() const noexcept -> const_iterator
 	{
-		return {std::cend(std::get<Is>(components))...};
+		return {&components, static_cast<difference_type>(size())};
 	}
 
 	auto rbegin() noexcept -> reverse_iterator
 	{
-		return {std::rbegin(std::get<Is>(components))...};
+		return reverse_iterator{end()};
 	}
 
 	[[nodiscard]]
-	auto rbegin() const noexcept -> reverse_iterator
+	auto rbegin() const noexcept -> const_reverse_iterator
 	{
-		return {std::rbegin(std::get<Is>(components))...};
+		return crbegin();
 	}
 
 	[[nodiscard]]
 	auto crbegin() const noexcept -> const_reverse_iterator
 	{
-		return {std::crbegin(std::get<Is>(components))...};
+		return const_reverse_iterator{cend()};
 	}
 
 	auto rend() noexcept -> reverse_iterator
 	{
-		return {std::rend(std::get<Is>(components))...};
+		return reverse_iterator{begin()};
 	}
 
 	[[nodiscard]]
-	auto rend() const noexcept -> reverse_iterator
+	auto rend() const noexcept -> const_reverse_iterator
 	{
-		return {std::rend(std::get<Is>(components))...};
+		return crend();
 	}
 
 	[[nodiscard]]
 	auto crend() const noexcept -> const_reverse_iterator
 	{
-		return {std::crend(std::get<Is>(components))...};
+		return const_reverse_iterator{cbegin()};
+	}
+
+	template <std::size_t... Js>
+	auto project() noexcept(nothrow_columns<Js...>) -> projection<std::tuple<std::tuple_element_t<Js, typename S::iterator>...>>
+	{
+		impl::record_views<Js...>(components);
+		return {{std::begin(components.template column<Js>())...}, size()};
+	}
+
+	template <std::size_t... Js>
+	[[nodiscard]]
+	auto project() const noexcept -> projection<std::tuple<std::tuple_element_t<Js, typename S::const_iterator>...>>
+	{
+		impl::record_views<Js...>(components);
+		return {{std::cbegin(components.template column<Js>())...}, size()};
+	}
+
+	template <auto... Members>
+	requires (... && std::is_same_v<T, typename member_index<Members>::class_type>)
+	auto columns() noexcept(nothrow_columns<member_index_v<Members>...>)
+	{
+		return project<member_index_v<Members>...>();
+	}
+
+	template <auto... Members>
+	requires (... && std::is_same_v<T, typename member_index<Members>::class_type>)
+	[[nodiscard]]
+	auto columns() const noexcept
+	{
+		return project<member_index_v<Members>...>();
+	}
+
+	template <fixed_string... Names>
+	auto columns() noexcept(nothrow_columns<field_index_v<T, Names>...>)
+	{
+		return project<field_index_v<T, Names>...>();
+	}
+
+	template <fixed_string... Names>
+	[[nodiscard]]
+	auto columns() const noexcept
+	{
+		return project<field_index_v<T, Names>...>();
+	}
+
+	// the storage of a single column, column<&T::x>() or column<"x">()
+	template <auto Member>
+	requires std::is_same_v<T, typename member_index<Member>::class_type>
+	auto column() noexcept(nothrow_columns<member_index_v<Member>>) -> decltype(auto)
+	{
+		impl::record_views<member_index_v<Member>>(components);
+		return components.template column<member_index_v<Member>>();
+	}
+
+	template <auto Member>
+	requires std::is_same_v<T, typename member_index<Member>::class_type>
+	[[nodiscard]]
+	auto column() const noexcept -> decltype(auto)
+	{
+		impl::record_views<member_index_v<Member>>(components);
+		return std::as_const(components).template column<member_index_v<Member>>();
+	}
+
+	template <fixed_string Name>
+	auto column() noexcept(nothrow_columns<field_index_v<T, Name>>) -> decltype(auto)
+	{
+		impl::record_views<field_index_v<T, Name>>(components);
+		return components.template column<field_index_v<T, Name>>();
+	}
+
+	template <fixed_string Name>
+	[[nodiscard]]
+	auto column() const noexcept -> decltype(auto)
+	{
+		impl::record_views<field_index_v<T, Name>>(components);
+		return std::as_const(components).template column<field_index_v<T, Name>>();
 	}
 
 	[[nodiscard]]
 	bool empty() const noexcept
 	{
-		return (... && std::empty(std::get<Is>(components)));
+		return components.empty();
 	}
 
 	[[nodiscard]]
 	auto size() const noexcept -> size_type
 	{
-		return {std::size(std::get<Is>(components))...};
+		return components.size();
 	}
 
 	[[nodiscard]]
 	auto max_size() const noexcept -> size_type
 	{
-		return {(std::get<Is>(components).max_size())...};
+		return components.max_size();
 	}
 
 	void reserve(const std::size_t new_cap)
 	{
-		(..., std::get<Is>(components).reserve(new_cap));
+		[[maybe_unused]] const tracker track{*this};
+		components.reserve(new_cap);
 	}
 
 	[[nodiscard]]
 	auto capacity() const noexcept -> size_type
 	{
-		return {(std::get<Is>(components).capacity())...};
+		return components.capacity();
 	}
 
 	void shrink_to_fit()
 	{
-		(..., std::get<Is>(components).shrink_to_fit());
+		[[maybe_unused]] const tracker track{*this};
+		components.shrink_to_fit();
 	}
 
 	void clear() noexcept
 	{
-		(..., std::get<Is>(components).clear());
+		[[maybe_unused]] const tracker track{*this};
+		components.clear();
 	}
 
 	template <typename U>
 	requires std::is_same_v<value_type, std::decay_t<U>>
 	auto insert(const const_iterator pos, U &&value) -> iterator
 	{
-		return {
-			std::get<Is>(components).insert(std::get<Is>(pos.iterators),
-			                                std::forward<decltype(std::get<Is>(value))>(std::get<Is>(value)))...
-		};
+		const auto index = pos - cbegin();
+		tracker track{*this};
+		track.moved(size() - static_cast<size_type>(index));
+		components.insert(index, std::forward<U>(value));
+		return begin() + index;
 	}
 
 	auto insert(const const_iterator pos, const size_type count, const value_type &value) -> iterator
 	{
-		return {std::get<Is>(components).insert(std::get<Is>(pos.iterators), count, std::get<Is>(value))...};
+		const auto index = pos - cbegin();
+		tracker track{*this};
+		track.moved(size() - static_cast<size_type>(index));
+		components.insert(index, count, value);
+		return begin() + index;
 	}
 
 	template <typename U>
@@ -368,48 +375,41 @@ struct struct_array_impl<T, std::index_sequence<Is...>>
 		return insert(pos, make_to_tuple<T>(std::forward<decltype(value)>(value)));
 	}
 
-private:
-	template <typename U>
-	requires(std::tuple_size_v<std::decay_t<U>> == sizeof...(Is))
-	auto emplace_impl(const const_iterator pos, U &&u) -> iterator
-	{
-		return {
-			std::apply(
-				[&](auto &&...xs)
-				{
-					return std::get<Is>(components).emplace(std::get<Is>(pos.iterators),
-					                                        std::forward<decltype(xs)>(xs)...);
-				}, std::forward<decltype(std::get<Is>(u))>(std::get<Is>(u)))
-			...
-		};
-	}
-
-public:
 	template <typename ...Args>
 	requires (sizeof...(Is) == sizeof...(Args))
 	auto emplace(const const_iterator pos, Args &&...args) -> iterator
 	{
-		return emplace_impl(pos, std::forward_as_tuple(std::forward<Args>(args)...));
+		const auto index = pos - cbegin();
+		tracker track{*this};
+		track.moved(size() - static_cast<size_type>(index));
+		components.emplace(index, std::forward<Args>(args)...);
+		return begin() + index;
 	}
 
 	auto erase(const const_iterator pos) -> iterator
 	{
-		return {std::get<Is>(components).erase(std::get<Is>(pos))...};
+		return erase(pos, pos + 1);
 	}
 
 	auto erase(const const_iterator first, const const_iterator last) -> iterator
 	{
-		return {std::get<Is>(components).erase(std::get<Is>(first), std::get<Is>(last))...};
+		const auto index = first - cbegin();
+		tracker track{*this};
+		track.moved(size() - static_cast<size_type>(last - cbegin()));
+		components.erase(index, last - cbegin());
+		return begin() + index;
 	}
 
 	void push_back(const value_type &value)
 	{
-		(..., std::get<Is>(components).push_back(std::get<Is>(value)));
+		[[maybe_unused]] const tracker track{*this};
+		components.push_back(value);
 	}
 
 	void push_back(value_type &&value)
 	{
-		(..., std::get<Is>(components).push_back(std::move(std::get<Is>(value))));
+		[[maybe_unused]] const tracker track{*this};
+		components.push_back(std::move(value));
 	}
 
 	template <typename U>
@@ -419,60 +419,108 @@ public:
 		push_back(std::move(make_to_tuple<T>(std::forward<decltype(value)>(value))));
 	}
 
-private:
-	template <typename U>
-	requires(std::tuple_size_v<std::decay_t<U>> == sizeof...(Is))
-	auto emplace_back_impl(U &&u) -> reference
-	{
-		return {
-			std::apply(
-				[&](auto &&...xs)
-				{
-					return std::ref(std::get<Is>(components).emplace_back(std::forward<decltype(xs)>(xs)...));
-				}, std::forward<decltype(std::get<Is>(u))>(std::get<Is>(u)))
-			...
-		};
-	}
-
-public:
 	template <typename...Args>
 	requires (sizeof...(Is) == sizeof...(Args))
 	auto emplace_back(Args &&... args) -> reference
 	{
-		return emplace_back_impl(std::forward_as_tuple(std::forward<Args>(args)...));
+		[[maybe_unused]] const tracker track{*this};
+		return components.emplace_back(std::forward<Args>(args)...);
+	}
+
+	// appends the T objects [first, last), forward ranges are transposed column by column in
+	// blocks of transpose_block_bytes after growing the capacity once
+	template <std::input_iterator It, std::sentinel_for<It> Sentinel>
+	requires std::is_same_v<T, std::remove_cvref_t<std::iter_reference_t<It>>>
+	void append(It first, const Sentinel last)
+	{
+		if constexpr (std::forward_iterator<It> && std::is_lvalue_reference_v<std::iter_reference_t<It>>)
+		{
+			constexpr auto block_rows = std::max(std::size_t{1U}, transpose_block_bytes / sizeof(T));
+			[[maybe_unused]] const tracker track{*this};
+
+			auto n = static_cast<size_type>(std::ranges::distance(first, last));
+			grow_for(n);
+			for (; n > 0U; n -= std::min(n, block_rows))
+			{
+				const auto rows = std::min(n, block_rows);
+				components.append(rows, field_iterator<Is, T, It>{first}...);
+				std::ranges::advance(first, static_cast<std::iter_difference_t<It>>(rows));
+			}
+		}
+		else
+		{
+			for (; first != last; ++first)
+				push_back(*first);
+		}
+	}
+
+	// appends one range per column, all of the same length, each copied in one go
+	void append_columns(const std::span<const std::tuple_element_t<Is, value_type>>... columns)
+	{
+		const auto n = std::size(std::get<0U>(std::forward_as_tuple(columns...)));
+		if (!(... && (std::size(columns) == n)))
+			throw std::invalid_argument{"soa::struct_array::append_columns: columns differ in length"};
+
+		[[maybe_unused]] const tracker track{*this};
+		grow_for(n);
+		components.append(n, std::data(columns)...);
 	}
 
 	void pop_back()
 	{
-		(..., std::get<Is>(components).pop_back());
+		[[maybe_unused]] const tracker track{*this};
+		components.pop_back();
 	}
 
 	void resize(const std::size_t count)
 	{
-		(..., std::get<Is>(components).resize(count));
+		[[maybe_unused]] const tracker track{*this};
+		components.resize(count);
 	}
 
 	void resize(const std::size_t count, const value_type &value)
 	{
-		(..., std::get<Is>(components).resize(count, std::get<Is>(value)));
+		[[maybe_unused]] const tracker track{*this};
+		components.resize(count, value);
 	}
 
-	void swap(struct_array_impl &other) noexcept(noexcept(std::get<Is>(components).swap(std::get<Is>(other.components))) && ...)
+	void swap(struct_array_impl &other) noexcept(noexcept(components.swap(other.components)))
+	{
+		components.swap(other.components);
+	}
+
+private:
+	// makes room for n more rows with at most one reallocation, growing geometrically; chunked
+	// storage never reallocates, so it only gets what is required
+	void grow_for(const size_type n)
+	{
+		if (const auto required = size() + n; required > capacity())
+		{
+			if constexpr (requires { S::chunk_size; })
+				components.reserve(required);
+			else
+				components.reserve(std::max(required, 2U * capacity()));
+		}
+	}
+
+public:
+	// friend hack to make swap visible to ADL
+	friend void swap(struct_array_impl &lhs, struct_array_impl &rhs) noexcept(noexcept(lhs.swap(rhs)))
 	{
-		(..., std::get<Is>(components).swap(std::get<Is>(other.components)));
+		lhs.swap(rhs);
 	}
 };
 } // namespace impl
 
-template <typename T>
+template <typename T, typename Layout = layout::vectors, typename Allocator = std::allocator<std::byte>>
 using struct_array = impl::struct_array_impl<
-	T, decltype(std::make_index_sequence<std::tuple_size_v<to_tuple_t<T>>>{})>;
+	T, decltype(std::make_index_sequence<std::tuple_size_v<to_tuple_t<T>>>{}), storage_t<T, Layout, Allocator>>;
 
-template <typename T>
-void swap(struct_array<T> &lhs, struct_array<T> &rhs) noexcept(noexcept(lhs.swap(rhs)))
+namespace pmr
 {
-	lhs.swap(rhs);
-}
+template <typename T, typename Layout = layout::vectors>
+using struct_array = soa::struct_array<T, Layout, std::pmr::polymorphic_allocator<std::byte>>;
+} // namespace pmr
 } // namespace soa
 
 #endif // SOA_STRUCT_ARRAY_H
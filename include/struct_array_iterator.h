@@ -0,0 +1,351 @@
+#ifndef SOA_STRUCT_ARRAY_ITERATOR_H
+#define SOA_STRUCT_ARRAY_ITERATOR_H
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "stats.h"
+#include "tuple_wrapper.h"
+
+namespace soa
+{
+namespace impl
+{
+template <typename U, typename>
+struct struct_array_iterator;
+
+template <typename U, std::size_t... Is>
+struct struct_array_iterator<U, std::index_sequence<Is...>>
+{
+	using value_type = tuple_wrapper<std::tuple<std::iter_value_t<std::tuple_element_t<Is, U>>...>>;
+	using difference_type = std::ptrdiff_t;
+	using reference = tuple_wrapper<std::tuple<std::iter_reference_t<std::tuple_element_t<Is, U>>...>>;
+	using pointer = std::tuple<decltype(std::to_address(std::declval<std::tuple_element_t<Is, U>>()))...>;
+	using iterator_category = std::random_access_iterator_tag;
+
+	U iterators;
+
+	struct_array_iterator() = default;
+	struct_array_iterator(const struct_array_iterator &) = default;
+	struct_array_iterator(struct_array_iterator &&) = default;
+
+	template <typename...Args>
+	requires (sizeof...(Is) == sizeof...(Args)) && (... && std::is_constructible_v<
+		std::tuple_element_t<Is, U>, Args>)
+	struct_array_iterator(Args &&...args)
+		: iterators{std::forward<Args>(args)...}
+	{
+	}
+
+	template <typename V>
+	requires (... && std::is_constructible_v<std::tuple_element_t<Is, U>, std::tuple_element_t<Is, V>>)
+	struct_array_iterator(const struct_array_iterator<V, std::index_sequence<Is...>> &that)
+		: iterators{std::get<Is>(that.iterators)...}
+	{
+	}
+
+	~struct_array_iterator() = default;
+
+	auto operator=(const struct_array_iterator &) -> struct_array_iterator& = default;
+	auto operator=(struct_array_iterator &&) -> struct_array_iterator& = default;
+
+	template <typename V>
+	requires (... && std::is_constructible_v<std::tuple_element_t<Is, U>, std::tuple_element_t<Is, V>>)
+	auto operator=(const struct_array_iterator<V, std::index_sequence<Is...>> &that) noexcept -> struct_array_iterator&
+	{
+		return *this = struct_array_iterator{that};
+	}
+
+	[[nodiscard]]
+	auto operator-(const difference_type n) const noexcept -> struct_array_iterator
+	{
+		return {(std::get<Is>(iterators) - n) ...};
+	}
+
+	[[nodiscard]]
+	auto operator-(const struct_array_iterator &that) const noexcept -> difference_type
+	{
+		return std::get<0>(iterators) - std::get<0>(that.iterators);
+	}
+
+	[[nodiscard]]
+	auto operator+=(const difference_type n) noexcept -> struct_array_iterator&
+	{
+		return *this = (*this + n);
+	}
+
+	[[nodiscard]]
+	auto operator-=(const difference_type n) noexcept -> struct_array_iterator&
+	{
+		return *this = (*this - n);
+	}
+
+	auto operator++() noexcept -> struct_array_iterator&
+	{
+		(..., ++std::get<Is>(iterators));
+		return *this;
+	}
+
+	auto operator++(int) noexcept -> struct_array_iterator
+	{
+		auto copy = *this;
+		++*this;
+		return copy;
+	}
+
+	auto operator--() noexcept -> struct_array_iterator&
+	{
+		(..., --std::get<Is>(iterators));
+		return *this;
+	}
+
+	auto operator--(int) noexcept -> struct_array_iterator
+	{
+		auto copy = *this;
+		--*this;
+		return copy;
+	}
+
+	auto operator*() const noexcept -> reference
+	{
+		return {std::make_tuple(std::ref(*(std::get<Is>(iterators)))...)};
+	}
+
+	auto operator->() const noexcept -> pointer
+	{
+		return {std::to_address(std::get<Is>(iterators))...};
+	}
+
+	auto operator[](const difference_type n) const noexcept -> reference
+	{
+		return *(*this + n);
+	}
+
+	/* TODO Fix noexcept specification */
+	void swap(struct_array_iterator &that) noexcept
+	{
+		std::swap(iterators, that.iterators);
+	}
+
+	[[nodiscard]]
+	bool operator==(const struct_array_iterator &that) const noexcept
+	{
+		return *this - that == 0;
+	}
+
+	[[nodiscard]]
+	bool operator!=(const struct_array_iterator &that) const noexcept
+	{
+		return !(*this == that);
+	}
+
+	[[nodiscard]]
+	bool operator<(const struct_array_iterator &that) const noexcept
+	{
+		return *this - that < 0;
+	}
+
+	[[nodiscard]]
+	bool operator>(const struct_array_iterator &that) const noexcept
+	{
+		return that < *this;
+	}
+
+	[[nodiscard]]
+	bool operator<=(const struct_array_iterator &that) const noexcept
+	{
+		return !(*this > that);
+	}
+
+	[[nodiscard]]
+	bool operator>=(const struct_array_iterator &that) const noexcept
+	{
+		return !(*this < that);
+	}
+
+	// friend hack to allow definition inside class template
+	friend auto operator+(const struct_array_iterator &it,
+	                      const difference_type n) noexcept -> struct_array_iterator
+	{
+		return {(std::get<Is>(it.iterators) + n)...};
+	}
+
+	// friend hack to allow definition inside class template
+	friend auto operator+(const difference_type n,
+	                      const struct_array_iterator &it) noexcept -> struct_array_iterator
+	{
+		return it + n;
+	}
+};
+
+template <typename S, typename>
+struct struct_array_index_iterator;
+
+// iterator of the owning containers: a pointer to the storage S (const S for const_iterator) and
+// a row index, so copying and advancing it costs the same for any number of columns; the column
+// begin iterators are looked up on dereference. It stays valid across reallocations, but not
+// when the container is moved or swapped
+template <typename S, std::size_t... Is>
+struct struct_array_index_iterator<S, std::index_sequence<Is...>>
+{
+	using columns_type = std::conditional_t<std::is_const_v<S>, typename S::const_iterator, typename S::iterator>;
+
+	using value_type = tuple_wrapper<std::tuple<std::iter_value_t<std::tuple_element_t<Is, columns_type>>...>>;
+	using difference_type = std::ptrdiff_t;
+	using reference = tuple_wrapper<std::tuple<std::iter_reference_t<std::tuple_element_t<Is, columns_type>>...>>;
+	using pointer = std::tuple<decltype(std::to_address(std::declval<std::tuple_element_t<Is, columns_type>>()))...>;
+	using iterator_category = std::random_access_iterator_tag;
+
+	// writable columns of a copy on write storage may have to be copied first
+	static constexpr bool nothrow_access = (... && noexcept(std::declval<S &>().template column<Is>()));
+
+	S *storage = nullptr;
+	difference_type index = 0;
+
+	struct_array_index_iterator() = default;
+
+	struct_array_index_iterator(S *const storage, const difference_type index) noexcept
+		: storage{storage}, index{index}
+	{
+	}
+
+	// iterator to const_iterator
+	template <typename V>
+	requires (!std::is_same_v<V, S>) && std::is_same_v<const V, S>
+	struct_array_index_iterator(const struct_array_index_iterator<V, std::index_sequence<Is...>> &that) noexcept
+		: storage{that.storage}, index{that.index}
+	{
+	}
+
+	[[nodiscard]]
+	auto operator-(const difference_type n) const noexcept -> struct_array_index_iterator
+	{
+		return {storage, index - n};
+	}
+
+	[[nodiscard]]
+	auto operator-(const struct_array_index_iterator &that) const noexcept -> difference_type
+	{
+		return index - that.index;
+	}
+
+	auto operator+=(const difference_type n) noexcept -> struct_array_index_iterator&
+	{
+		index += n;
+		return *this;
+	}
+
+	auto operator-=(const difference_type n) noexcept -> struct_array_index_iterator&
+	{
+		index -= n;
+		return *this;
+	}
+
+	auto operator++() noexcept -> struct_array_index_iterator&
+	{
+		++index;
+		return *this;
+	}
+
+	auto operator++(int) noexcept -> struct_array_index_iterator
+	{
+		auto copy = *this;
+		++index;
+		return copy;
+	}
+
+	auto operator--() noexcept -> struct_array_index_iterator&
+	{
+		--index;
+		return *this;
+	}
+
+	auto operator--(int) noexcept -> struct_array_index_iterator
+	{
+		auto copy = *this;
+		--index;
+		return copy;
+	}
+
+	auto operator*() const noexcept(nothrow_access) -> reference
+	{
+		record_access(*storage);
+		return {std::make_tuple(std::ref(std::begin(storage->template column<Is>())[index])...)};
+	}
+
+	auto operator->() const noexcept(nothrow_access) -> pointer
+	{
+		record_access(*storage);
+		return {std::to_address(std::begin(storage->template column<Is>()) + index)...};
+	}
+
+	auto operator[](const difference_type n) const noexcept(nothrow_access) -> reference
+	{
+		return *(*this + n);
+	}
+
+	void swap(struct_array_index_iterator &that) noexcept
+	{
+		std::swap(storage, that.storage);
+		std::swap(index, that.index);
+	}
+
+	[[nodiscard]]
+	bool operator==(const struct_array_index_iterator &that) const noexcept
+	{
+		return index == that.index;
+	}
+
+	[[nodiscard]]
+	bool operator!=(const struct_array_index_iterator &that) const noexcept
+	{
+		return !(*this == that);
+	}
+
+	[[nodiscard]]
+	bool operator<(const struct_array_index_iterator &that) const noexcept
+	{
+		return index < that.index;
+	}
+
+	[[nodiscard]]
+	bool operator>(const struct_array_index_iterator &that) const noexcept
+	{
+		return that < *this;
+	}
+
+	[[nodiscard]]
+	bool operator<=(const struct_array_index_iterator &that) const noexcept
+	{
+		return !(*this > that);
+	}
+
+	[[nodiscard]]
+	bool operator>=(const struct_array_index_iterator &that) const noexcept
+	{
+		return !(*this < that);
+	}
+
+	// friend hack to allow definition inside class template
+	friend auto operator+(const struct_array_index_iterator &it,
+	                      const difference_type n) noexcept -> struct_array_index_iterator
+	{
+		return {it.storage, it.index + n};
+	}
+
+	// friend hack to allow definition inside class template
+	friend auto operator+(const difference_type n,
+	                      const struct_array_index_iterator &it) noexcept -> struct_array_index_iterator
+	{
+		return it + n;
+	}
+};
+} // namespace impl
+} // namespace soa
+
+#endif // SOA_STRUCT_ARRAY_ITERATOR_H
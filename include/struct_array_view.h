@@ -0,0 +1,255 @@
+#ifndef SOA_STRUCT_ARRAY_VIEW_H
+#define SOA_STRUCT_ARRAY_VIEW_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "fields.h"
+#include "projection.h"
+#include "struct_array_iterator.h"
+#include "to_tuple.h"
+
+namespace soa
+{
+namespace impl
+{
+// column types of a view of T, const T gives read-only columns
+template <typename T>
+struct view_columns
+{
+	using type = to_tuple_t<T>;
+};
+
+template <typename T>
+struct const_columns;
+
+template <typename... Ts>
+struct const_columns<std::tuple<Ts...>>
+{
+	using type = std::tuple<const Ts...>;
+};
+
+template <typename T>
+struct view_columns<const T> : const_columns<to_tuple_t<T>>
+{
+};
+
+template <typename T>
+using view_columns_t = typename view_columns<T>::type;
+
+template <typename T, typename, typename S>
+struct struct_array_impl;
+
+template <typename T, typename, typename U>
+struct struct_array_view_impl;
+
+// non-owning view over count rows of contiguous columns that live elsewhere, a view of const T
+// only hands out const references
+template <typename T, std::size_t... Is, typename... Ts>
+struct struct_array_view_impl<T, std::index_sequence<Is...>, std::tuple<Ts...>>
+{
+	using struct_type = std::remove_const_t<T>;
+	using value_type = std::tuple<std::remove_cv_t<Ts>...>;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = std::tuple<Ts &...>;
+	using const_reference = std::tuple<const Ts &...>;
+	using pointer = std::tuple<Ts *...>;
+	using const_pointer = std::tuple<const Ts *...>;
+
+	template <typename U>
+	using struct_array_iterator = impl::struct_array_iterator<U, std::index_sequence<Is...>>;
+
+	using iterator = struct_array_iterator<pointer>;
+	using const_iterator = struct_array_iterator<const_pointer>;
+	using reverse_iterator = struct_array_iterator<std::tuple<std::reverse_iterator<Ts *>...>>;
+	using const_reverse_iterator = struct_array_iterator<std::tuple<std::reverse_iterator<const Ts *>...>>;
+
+	struct_array_view_impl() noexcept = default;
+
+	struct_array_view_impl(const pointer &first, const size_type count) noexcept
+		: first{first}, count{count}
+	{
+	}
+
+	// one pointer per column followed by the row count
+	template <typename... Ps>
+	requires (sizeof...(Ps) == sizeof...(Ts) + 1U)
+	explicit struct_array_view_impl(Ps... args) noexcept
+		: struct_array_view_impl{split(std::forward_as_tuple(args...))}
+	{
+	}
+
+	// every row of a struct_array whose columns are contiguous
+	template <typename A, typename S = typename std::remove_const_t<A>::storage_type>
+	requires std::is_same_v<std::remove_const_t<A>, struct_array_impl<std::remove_const_t<T>, std::index_sequence<Is...>, S>>
+		&& (... && std::contiguous_iterator<std::tuple_element_t<Is, typename S::iterator>>)
+		&& std::is_convertible_v<decltype(std::declval<A &>().data()), pointer>
+	struct_array_view_impl(A &array) noexcept
+		: first{array.data()}, count{std::size(array)}
+	{
+	}
+
+	// view of T to view of const T
+	template <typename U, typename... Us>
+	requires (... && std::is_convertible_v<Us *, Ts *>)
+	struct_array_view_impl(const struct_array_view_impl<U, std::index_sequence<Is...>, std::tuple<Us...>> &that) noexcept
+		: first{that.data()}, count{std::size(that)}
+	{
+	}
+
+	auto operator[](const std::size_t pos) const noexcept -> reference
+	{
+		return *(begin() + pos);
+	}
+
+	[[nodiscard]]
+	auto front() const noexcept -> reference
+	{
+		return *begin();
+	}
+
+	[[nodiscard]]
+	auto back() const noexcept -> reference
+	{
+		return *(end() - 1);
+	}
+
+	[[nodiscard]]
+	auto data() const noexcept -> pointer
+	{
+		return first;
+	}
+
+	[[nodiscard]]
+	auto begin() const noexcept -> iterator
+	{
+		return {std::get<Is>(first)...};
+	}
+
+	[[nodiscard]]
+	auto cbegin() const noexcept -> const_iterator
+	{
+		return begin();
+	}
+
+	[[nodiscard]]
+	auto end() const noexcept -> iterator
+	{
+		return {(std::get<Is>(first) + count)...};
+	}
+
+	[[nodiscard]]
+	auto cend() const noexcept -> const_iterator
+	{
+		return end();
+	}
+
+	[[nodiscard]]
+	auto rbegin() const noexcept -> reverse_iterator
+	{
+		return {std::make_reverse_iterator(std::get<Is>(first) + count)...};
+	}
+
+	[[nodiscard]]
+	auto crbegin() const noexcept -> const_reverse_iterator
+	{
+		return {std::make_reverse_iterator(static_cast<const Ts *>(std::get<Is>(first) + count))...};
+	}
+
+	[[nodiscard]]
+	auto rend() const noexcept -> reverse_iterator
+	{
+		return {std::make_reverse_iterator(std::get<Is>(first))...};
+	}
+
+	[[nodiscard]]
+	auto crend() const noexcept -> const_reverse_iterator
+	{
+		return {std::make_reverse_iterator(static_cast<const Ts *>(std::get<Is>(first)))...};
+	}
+
+	template <std::size_t... Js>
+	[[nodiscard]]
+	auto project() const noexcept -> projection<std::tuple<std::tuple_element_t<Js, pointer>...>>
+	{
+		return {{std::get<Js>(first)...}, count};
+	}
+
+	template <auto... Members>
+	requires (... && std::is_same_v<std::remove_const_t<T>, typename member_index<Members>::class_type>)
+	[[nodiscard]]
+	auto columns() const noexcept
+	{
+		return project<member_index_v<Members>...>();
+	}
+
+	template <fixed_string... Names>
+	[[nodiscard]]
+	auto columns() const noexcept
+	{
+		return project<field_index_v<std::remove_const_t<T>, Names>...>();
+	}
+
+	// a single column as a span, column<&T::x>() or column<"x">()
+	template <auto Member>
+	requires std::is_same_v<std::remove_const_t<T>, typename member_index<Member>::class_type>
+	[[nodiscard]]
+	auto column() const noexcept
+	{
+		return std::span{std::get<member_index_v<Member>>(first), count};
+	}
+
+	template <fixed_string Name>
+	[[nodiscard]]
+	auto column() const noexcept
+	{
+		return std::span{std::get<field_index_v<std::remove_const_t<T>, Name>>(first), count};
+	}
+
+	// rows [offset, offset + n) of this view, offset is clamped to size() and n to the rows left
+	[[nodiscard]]
+	auto subview(const size_type offset, const size_type n = static_cast<size_type>(-1)) const noexcept
+		-> struct_array_view_impl
+	{
+		const auto start = std::min(offset, count);
+		return {{(std::get<Is>(first) + start)...}, std::min(n, count - start)};
+	}
+
+	[[nodiscard]]
+	bool empty() const noexcept
+	{
+		return count == 0U;
+	}
+
+	[[nodiscard]]
+	auto size() const noexcept -> size_type
+	{
+		return count;
+	}
+
+private:
+	pointer first{};
+	size_type count = 0U;
+
+	template <typename U>
+	[[nodiscard]]
+	static auto split(U &&args) noexcept -> struct_array_view_impl
+	{
+		return {{std::get<Is>(args)...}, static_cast<size_type>(std::get<sizeof...(Ts)>(args))};
+	}
+};
+} // namespace impl
+
+template <typename T>
+using struct_array_view = impl::struct_array_view_impl<
+	T, decltype(std::make_index_sequence<std::tuple_size_v<to_tuple_t<std::remove_const_t<T>>>>{}),
+	impl::view_columns_t<T>>;
+} // namespace soa
+
+#endif // SOA_STRUCT_ARRAY_VIEW_H
@@ -0,0 +1,331 @@
+#ifndef SOA_STRUCT_SLOT_MAP_H
+#define SOA_STRUCT_SLOT_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "struct_array.h"
+
+namespace soa
+{
+// refers to one element of a struct_slot_map until that element is erased
+struct slot_handle
+{
+	std::uint32_t index = static_cast<std::uint32_t>(-1);
+	std::uint32_t generation = 0U;
+
+	friend bool operator==(const slot_handle &, const slot_handle &) = default;
+};
+
+// struct_array whose elements are addressed through stable handles. Rows stay dense so iteration
+// and the column algorithms see a plain struct_array; erase moves the last row into the hole, so
+// it costs one row move instead of shifting every column. Handles go through a slot table whose
+// generation is bumped on every erase, stale handles are detected instead of aliasing a new element.
+template <typename T, typename Layout = layout::vectors, typename Allocator = std::allocator<std::byte>>
+class struct_slot_map
+{
+	template <typename U>
+	using vector = std::vector<U, typename std::allocator_traits<Allocator>::template rebind_alloc<U>>;
+
+public:
+	using array_type = struct_array<T, Layout, Allocator>;
+	using handle = slot_handle;
+	using allocator_type = Allocator;
+	using value_type = typename array_type::value_type;
+	using size_type = typename array_type::size_type;
+	using difference_type = typename array_type::difference_type;
+	using reference = typename array_type::reference;
+	using const_reference = typename array_type::const_reference;
+	using iterator = typename array_type::iterator;
+	using const_iterator = typename array_type::const_iterator;
+
+	struct_slot_map() = default;
+
+	explicit struct_slot_map(const Allocator &alloc)
+		: rows{alloc}, owners(alloc), slots(alloc)
+	{
+	}
+
+	[[nodiscard]]
+	auto get_allocator() const noexcept -> allocator_type
+	{
+		return rows.get_allocator();
+	}
+
+	template <typename U>
+	requires std::is_same_v<T, std::decay_t<U>>
+	auto insert(U &&value) -> handle
+	{
+		return claim([&] { rows.push_back(std::forward<U>(value)); });
+	}
+
+	template <typename...Args>
+	requires (sizeof...(Args) == std::tuple_size_v<value_type>)
+	auto emplace(Args &&...args) -> handle
+	{
+		return claim([&] { rows.emplace_back(std::forward<Args>(args)...); });
+	}
+
+	// removes the element of h by moving the last row into its place, false if h is stale
+	bool erase(const handle h)
+	{
+		if (!contains(h))
+			return false;
+
+		const auto pos = slots[h.index].index;
+		const auto last = static_cast<std::uint32_t>(std::size(rows) - 1U);
+		if (pos != last)
+		{
+			move_row(last, pos, std::make_index_sequence<std::tuple_size_v<value_type>>{});
+			owners[pos] = owners[last];
+			slots[owners[pos]].index = pos;
+		}
+		rows.pop_back();
+		owners.pop_back();
+		release(h.index);
+		return true;
+	}
+
+	[[nodiscard]]
+	bool contains(const handle h) const noexcept
+	{
+		return h.index < std::size(slots) && slots[h.index].generation == h.generation;
+	}
+
+	// h has to be valid
+	auto operator[](const handle h) -> reference
+	{
+		return rows[slots[h.index].index];
+	}
+
+	auto operator[](const handle h) const -> const_reference
+	{
+		return rows[slots[h.index].index];
+	}
+
+	[[nodiscard]]
+	auto at(const handle h) -> reference
+	{
+		check(h);
+		return (*this)[h];
+	}
+
+	[[nodiscard]]
+	auto at(const handle h) const -> const_reference
+	{
+		check(h);
+		return (*this)[h];
+	}
+
+	// iterator to the row of h, end() if h is stale
+	[[nodiscard]]
+	auto find(const handle h) noexcept -> iterator
+	{
+		return contains(h) ? std::begin(rows) + slots[h.index].index : std::end(rows);
+	}
+
+	[[nodiscard]]
+	auto find(const handle h) const noexcept -> const_iterator
+	{
+		return contains(h) ? std::begin(rows) + slots[h.index].index : std::end(rows);
+	}
+
+	// handle of the element currently stored in row pos
+	[[nodiscard]]
+	auto handle_of(const size_type pos) const noexcept -> handle
+	{
+		return {owners[pos], slots[owners[pos]].generation};
+	}
+
+	// the dense rows, positions change on erase
+	[[nodiscard]]
+	auto values() const noexcept -> const array_type&
+	{
+		return rows;
+	}
+
+	[[nodiscard]]
+	auto begin() noexcept -> iterator
+	{
+		return std::begin(rows);
+	}
+
+	[[nodiscard]]
+	auto begin() const noexcept -> const_iterator
+	{
+		return std::begin(rows);
+	}
+
+	[[nodiscard]]
+	auto cbegin() const noexcept -> const_iterator
+	{
+		return begin();
+	}
+
+	[[nodiscard]]
+	auto end() noexcept -> iterator
+	{
+		return std::end(rows);
+	}
+
+	[[nodiscard]]
+	auto end() const noexcept -> const_iterator
+	{
+		return std::end(rows);
+	}
+
+	[[nodiscard]]
+	auto cend() const noexcept -> const_iterator
+	{
+		return end();
+	}
+
+	template <std::size_t... Js>
+	[[nodiscard]]
+	auto project() noexcept
+	{
+		return rows.template project<Js...>();
+	}
+
+	template <std::size_t... Js>
+	[[nodiscard]]
+	auto project() const noexcept
+	{
+		return rows.template project<Js...>();
+	}
+
+	template <auto... Members>
+	[[nodiscard]]
+	auto columns() noexcept
+	{
+		return rows.template columns<Members...>();
+	}
+
+	template <auto... Members>
+	[[nodiscard]]
+	auto columns() const noexcept
+	{
+		return rows.template columns<Members...>();
+	}
+
+	[[nodiscard]]
+	bool empty() const noexcept
+	{
+		return std::empty(rows);
+	}
+
+	[[nodiscard]]
+	auto size() const noexcept -> size_type
+	{
+		return std::size(rows);
+	}
+
+	[[nodiscard]]
+	auto capacity() const noexcept -> size_type
+	{
+		return rows.capacity();
+	}
+
+	void reserve(const size_type new_cap)
+	{
+		rows.reserve(new_cap);
+		owners.reserve(new_cap);
+		slots.reserve(new_cap);
+	}
+
+	// erases every element, all handles become stale
+	void clear() noexcept
+	{
+		for (const auto index : owners)
+			release(index);
+		rows.clear();
+		owners.clear();
+	}
+
+	void swap(struct_slot_map &other) noexcept
+	{
+		using std::swap;
+		swap(rows, other.rows);
+		swap(owners, other.owners);
+		swap(slots, other.slots);
+		swap(free_head, other.free_head);
+	}
+
+	// friend hack to make swap visible to ADL
+	friend void swap(struct_slot_map &lhs, struct_slot_map &rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+private:
+	static constexpr std::uint32_t no_slot = static_cast<std::uint32_t>(-1);
+
+	// index is the row of an occupied slot and the next free slot of a free one
+	struct slot
+	{
+		std::uint32_t index;
+		std::uint32_t generation;
+	};
+
+	array_type rows;
+	vector<std::uint32_t> owners; // slot of every row
+	vector<slot> slots;
+	std::uint32_t free_head = no_slot;
+
+	// push adds the new row, everything it may throw happens before a slot is taken
+	template <typename F>
+	auto claim(F &&push) -> handle
+	{
+		if (free_head == no_slot)
+		{
+			if (std::size(slots) >= no_slot)
+				throw std::length_error{"soa::struct_slot_map: too many slots"};
+			slots.push_back({no_slot, 0U});
+			free_head = static_cast<std::uint32_t>(std::size(slots) - 1U);
+		}
+
+		owners.push_back(free_head);
+		try
+		{
+			push();
+		}
+		catch (...)
+		{
+			owners.pop_back();
+			throw;
+		}
+
+		const auto index = std::exchange(free_head, slots[free_head].index);
+		slots[index].index = static_cast<std::uint32_t>(std::size(rows) - 1U);
+		return {index, slots[index].generation};
+	}
+
+	void release(const std::uint32_t index) noexcept
+	{
+		slots[index] = {free_head, slots[index].generation + 1U};
+		free_head = index;
+	}
+
+	template <std::size_t... Is>
+	void move_row(const std::size_t from, const std::size_t to, std::index_sequence<Is...>)
+	{
+		const auto columns = rows.template project<Is...>().first;
+		(..., (std::get<Is>(columns)[static_cast<difference_type>(to)] =
+			std::move(std::get<Is>(columns)[static_cast<difference_type>(from)])));
+	}
+
+	void check(const handle h) const
+	{
+		if (!contains(h))
+			throw std::out_of_range{"soa::struct_slot_map: stale handle"};
+	}
+};
+} // namespace soa
+
+#endif // SOA_STRUCT_SLOT_MAP_H
@@ -0,0 +1,189 @@
+#ifndef SOA_THREAD_POOL_H
+#define SOA_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace soa
+{
+// fork-join pool, run() splits a loop of tasks over the workers and the calling thread
+class thread_pool
+{
+public:
+	explicit thread_pool(const std::size_t threads = default_concurrency())
+	{
+		const auto workers_count = std::max<std::size_t>(threads, 1U) - 1U;
+		workers.reserve(workers_count);
+		for (std::size_t i = 0U; i < workers_count; ++i)
+			workers.emplace_back([this] { work(); });
+	}
+
+	thread_pool(const thread_pool &) = delete;
+	thread_pool(thread_pool &&) = delete;
+
+	~thread_pool()
+	{
+		{
+			std::scoped_lock lock{mutex};
+			stopping = true;
+		}
+		wake.notify_all();
+		for (auto &worker : workers)
+			worker.join();
+	}
+
+	auto operator=(const thread_pool &) -> thread_pool& = delete;
+	auto operator=(thread_pool &&) -> thread_pool& = delete;
+
+	// number of threads taking part in run(), including the caller
+	[[nodiscard]]
+	auto size() const noexcept -> std::size_t
+	{
+		return workers.size() + 1U;
+	}
+
+	// calls f(i) for every i in [0, tasks) and returns once all of them finished, rethrows the
+	// first exception; nested calls from inside a task run inline
+	template <typename F>
+	void run(const std::size_t tasks, F &&f)
+	{
+		if (tasks == 0U)
+			return;
+
+		if (tasks == 1U || workers.empty() || current == this)
+		{
+			for (std::size_t i = 0U; i < tasks; ++i)
+				f(i);
+			return;
+		}
+
+		std::scoped_lock submit_lock{submit};
+
+		job j{
+			[](void *context, const std::size_t i) { (*static_cast<std::remove_reference_t<F> *>(context))(i); },
+			std::addressof(f), tasks
+		};
+
+		{
+			std::scoped_lock lock{mutex};
+			pending = &j;
+			++generation;
+		}
+		wake.notify_all();
+
+		// tasks the caller runs count as inside the pool too, so their nested calls run inline
+		// instead of waiting for submit
+		const auto *const outer = std::exchange(current, this);
+		execute(j);
+		current = outer;
+
+		{
+			std::unique_lock lock{mutex};
+			done.wait(lock, [&] { return active == 0U; });
+			pending = nullptr;
+		}
+
+		if (j.error)
+			std::rethrow_exception(j.error);
+	}
+
+	// pool shared by the std::execution::par overloads
+	[[nodiscard]]
+	static auto global() -> thread_pool&
+	{
+		static thread_pool pool;
+		return pool;
+	}
+
+	[[nodiscard]]
+	static auto default_concurrency() noexcept -> std::size_t
+	{
+		return std::max(std::thread::hardware_concurrency(), 1U);
+	}
+
+private:
+	struct job
+	{
+		job(void (*invoke)(void *, std::size_t), void *context, const std::size_t tasks) noexcept
+			: invoke{invoke}, context{context}, tasks{tasks}
+		{
+		}
+
+		void (*invoke)(void *, std::size_t);
+		void *context;
+		std::size_t tasks;
+		std::atomic<std::size_t> next{0U};
+		std::mutex error_mutex;
+		std::exception_ptr error;
+	};
+
+	inline static thread_local const thread_pool *current = nullptr;
+
+	std::vector<std::thread> workers;
+	std::mutex submit;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	job *pending = nullptr;
+	std::size_t generation = 0U;
+	std::size_t active = 0U;
+	bool stopping = false;
+
+	static void execute(job &j) noexcept
+	{
+		for (auto i = j.next.fetch_add(1U); i < j.tasks; i = j.next.fetch_add(1U))
+		{
+			try
+			{
+				j.invoke(j.context, i);
+			}
+			catch (...)
+			{
+				std::scoped_lock lock{j.error_mutex};
+				if (!j.error)
+					j.error = std::current_exception();
+				j.next = j.tasks;
+			}
+		}
+	}
+
+	void work()
+	{
+		current = this;
+		std::size_t seen = 0U;
+
+		for (;;)
+		{
+			job *j;
+			{
+				std::unique_lock lock{mutex};
+				wake.wait(lock, [&] { return stopping || (pending != nullptr && generation != seen); });
+				if (stopping)
+					return;
+				seen = generation;
+				j = pending;
+				++active;
+			}
+
+			execute(*j);
+
+			{
+				std::scoped_lock lock{mutex};
+				--active;
+			}
+			done.notify_all();
+		}
+	}
+};
+} // namespace soa
+
+#endif // SOA_THREAD_POOL_H
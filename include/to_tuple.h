@@ -3,11 +3,13 @@
 
 #include <cstddef>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 
 #include <boost/preprocessor.hpp>
 
 #include "bind.h"
+#include "describe.h"
 
 namespace soa
 {
@@ -24,21 +26,33 @@ struct to_tuple_impl<0U, T>
 		return std::make_tuple();
 	};
 
+	static constexpr auto tie = [](auto &) noexcept
+	{
+		return std::tie();
+	};
+
 	using type = decltype(make(std::declval<T>()));
 };
 
 #define SOA_IDENTIFIER(z, i, text) BOOST_PP_COMMA_IF(i) BOOST_PP_CAT(text, i)
 #define SOA_IDENTIFIER_LIST(n) BOOST_PP_REPEAT(n, SOA_IDENTIFIER, _)
-#define SOA_FORWARD(z, data, text) std::forward<decltype(text)>(text)
-#define SOA_FORWARD_IDENTIFIER_LIST(...)      \
-  BOOST_PP_LIST_ENUM(BOOST_PP_LIST_TRANSFORM( \
-      SOA_FORWARD, 0, BOOST_PP_VARIADIC_TO_LIST(__VA_ARGS__)))
+// binding i of x, moved from only when x is an rvalue
+#define SOA_FORWARD(z, i, text)                                                     \
+  BOOST_PP_COMMA_IF(i)                                                              \
+  static_cast<std::conditional_t<std::is_lvalue_reference_v<decltype(x)>,          \
+                                 decltype(BOOST_PP_CAT(text, i)) &,                 \
+                                 decltype(BOOST_PP_CAT(text, i)) &&>>(BOOST_PP_CAT(text, i))
+#define SOA_FORWARD_IDENTIFIER_LIST(n) BOOST_PP_REPEAT(n, SOA_FORWARD, _)
 #define SOA_TO_TUPLE_IMPL(i, ...)                                       \
   template <typename T>                                                 \
   struct to_tuple_impl<i, T> {                                          \
     static constexpr auto make = [](auto &&x) noexcept {                \
       auto &&[__VA_ARGS__] = std::forward<decltype(x)>(x);              \
-      return std::make_tuple(SOA_FORWARD_IDENTIFIER_LIST(__VA_ARGS__)); \
+      return std::make_tuple(SOA_FORWARD_IDENTIFIER_LIST(i));           \
+    };                                                                  \
+    static constexpr auto tie = [](auto &x) noexcept {                  \
+      auto &[__VA_ARGS__] = x;                                          \
+      return std::tie(__VA_ARGS__);                                     \
     };                                                                  \
     using type = decltype(make(std::declval<T>()));                     \
   };
@@ -50,18 +64,102 @@ BOOST_PP_REPEAT_FROM_TO(1, SOA_MAX_BINDINGS, SOA_TO_TUPLE, 0)
 #undef SOA_TO_TUPLE
 #undef SOA_TO_TUPLE_IMPL
 #undef SOA_FORWARD_IDENTIFIER_LIST
+#undef SOA_FORWARD
 #undef SOA_IDENTIFIER_LIST
 #undef SOA_IDENTIFIER
+
+// described types go through their member pointers instead of structured bindings
+template <typename T>
+struct described_to_tuple
+{
+	static constexpr auto make = [](auto &&x) noexcept
+	{
+		return std::apply([&](const auto... members)
+		{
+			return std::make_tuple((std::forward<decltype(x)>(x).*members)...);
+		}, description_v<T>.members);
+	};
+
+	static constexpr auto tie = [](auto &x) noexcept
+	{
+		return std::apply([&](const auto... members) { return std::tie((x.*members)...); }, description_v<T>.members);
+	};
+
+	using type = decltype(make(std::declval<T>()));
+};
+
+template <typename T>
+struct select_to_tuple
+{
+	using type = to_tuple_impl<max_bind_v<T>, T>;
+};
+
+template <described T>
+struct select_to_tuple<T>
+{
+	using type = described_to_tuple<T>;
+};
 } // namespace impl
 
 template <typename T>
-using to_tuple = impl::to_tuple_impl<max_bind_v<T>, T>;
+using to_tuple = typename impl::select_to_tuple<T>::type;
 
 template <typename T>
 using to_tuple_t = typename to_tuple<T>::type;
 
 template <typename T>
 inline static constexpr auto make_to_tuple = to_tuple<T>::make;
+
+template <typename T>
+inline static constexpr auto make_tie = to_tuple<T>::tie;
+
+namespace impl
+{
+template <typename T, typename M, std::size_t... Is>
+constexpr auto member_index_impl(M T::*member, std::index_sequence<Is...>) -> std::size_t
+{
+	T object{};
+	const auto fields = make_tie<T>(object);
+	const auto *const address = static_cast<const void *>(&(object.*member));
+
+	auto index = sizeof...(Is);
+	(..., (static_cast<const void *>(&std::get<Is>(fields)) == address ? index = Is : index));
+	return index;
+}
+
+template <described T, typename M, std::size_t... Is>
+constexpr auto member_index_impl(M T::*member, std::index_sequence<Is...>) -> std::size_t
+{
+	constexpr auto &members = description_v<T>.members;
+
+	auto index = sizeof...(Is);
+	(..., [&]
+	{
+		if constexpr (std::is_same_v<std::tuple_element_t<Is, std::remove_cvref_t<decltype(members)>>, M T::*>)
+			if (std::get<Is>(members) == member)
+				index = Is;
+	}());
+	return index;
+}
+} // namespace impl
+
+// position of a data member among the bindings of T; unless T is described, this requires T{} to be
+// a constant expression
+template <auto Member>
+struct member_index;
+
+template <typename T, typename M, M T::*Member>
+struct member_index<Member>
+	: std::integral_constant<std::size_t, impl::member_index_impl(
+		Member, std::make_index_sequence<std::tuple_size_v<to_tuple_t<T>>>{})>
+{
+	using class_type = T;
+
+	static_assert(member_index::value < std::tuple_size_v<to_tuple_t<T>>, "member is not bound by to_tuple");
+};
+
+template <auto Member>
+inline static constexpr auto member_index_v = member_index<Member>::value;
 } // namespace soa
 
 namespace soa
@@ -71,7 +169,15 @@ namespace impl
 template <typename T, typename Tuple, std::size_t... I>
 constexpr T make_from_tuple_impl(Tuple &&t, std::index_sequence<I...>)
 {
-	return T{std::get<I>(std::forward<Tuple>(t))...};
+	if constexpr (described<T>)
+	{
+		// the listed members need not be all of T's or in declaration order, so assign them one by one
+		T object{};
+		(..., (object.*std::get<I>(description_v<T>.members) = std::get<I>(std::forward<Tuple>(t))));
+		return object;
+	}
+	else
+		return T{std::get<I>(std::forward<Tuple>(t))...};
 }
 } // namespace impl
 
@@ -1,7 +1,12 @@
 #ifndef SOA_VECTORIZE_H
 #define SOA_VECTORIZE_H
 
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include "to_tuple.h"
@@ -10,33 +15,228 @@ namespace soa
 {
 namespace impl
 {
-template <typename T>
+// every column gets Allocator rebound to its own element type
+template <typename T, typename Allocator = std::allocator<std::byte>>
 struct vectorize_impl;
 
-template <typename... Ts>
-struct vectorize_impl<std::tuple<Ts...>>
+template <typename... Ts, typename Allocator>
+struct vectorize_impl<std::tuple<Ts...>, Allocator>
 {
-	using type = std::tuple<std::vector<Ts>...>;
-	using value_type = std::tuple<typename std::vector<Ts>::value_type...>;
-	using allocator_type = std::tuple<typename std::vector<Ts>::allocator_type...>;
-	using size_type = std::tuple<typename std::vector<Ts>::size_type...>;
-	using difference_type = std::tuple<typename std::vector<Ts>::difference_type...>;
-	using reference = std::tuple<typename std::vector<Ts>::reference...>;
-	using const_reference = std::tuple<typename std::vector<Ts>::const_reference...>;
-	using pointer = std::tuple<typename std::vector<Ts>::pointer...>;
-	using const_pointer = std::tuple<typename std::vector<Ts>::const_pointer...>;
-	using iterator = std::tuple<typename std::vector<Ts>::iterator...>;
-	using const_iterator = std::tuple<typename std::vector<Ts>::const_iterator...>;
-	using reverse_iterator = std::tuple<typename std::vector<Ts>::reverse_iterator...>;
-	using const_reverse_iterator = std::tuple<typename std::vector<Ts>::const_reverse_iterator...>;
+	template <typename U>
+	using vector = std::vector<U, typename std::allocator_traits<Allocator>::template rebind_alloc<U>>;
+
+	using type = std::tuple<vector<Ts>...>;
+	using value_type = std::tuple<typename vector<Ts>::value_type...>;
+	using allocator_type = std::tuple<typename vector<Ts>::allocator_type...>;
+	using size_type = std::tuple<typename vector<Ts>::size_type...>;
+	using difference_type = std::tuple<typename vector<Ts>::difference_type...>;
+	using reference = std::tuple<typename vector<Ts>::reference...>;
+	using const_reference = std::tuple<typename vector<Ts>::const_reference...>;
+	using pointer = std::tuple<typename vector<Ts>::pointer...>;
+	using const_pointer = std::tuple<typename vector<Ts>::const_pointer...>;
+	using iterator = std::tuple<typename vector<Ts>::iterator...>;
+	using const_iterator = std::tuple<typename vector<Ts>::const_iterator...>;
+	using reverse_iterator = std::tuple<typename vector<Ts>::reverse_iterator...>;
+	using const_reverse_iterator = std::tuple<typename vector<Ts>::const_reverse_iterator...>;
 };
 } // namespace impl
 
-template <typename T>
-using vectorize = impl::vectorize_impl<to_tuple_t<T>>;
+template <typename T, typename Allocator = std::allocator<std::byte>>
+using vectorize = impl::vectorize_impl<to_tuple_t<T>, Allocator>;
+
+template <typename T, typename Allocator = std::allocator<std::byte>>
+using vectorize_t = typename vectorize<T, Allocator>::type;
+
+namespace impl
+{
+template <typename T, typename, typename Allocator>
+struct column_vectors;
+
+// one std::vector per field, every column keeps its own size and capacity
+template <typename... Ts, std::size_t... Is, typename Allocator>
+struct column_vectors<std::tuple<Ts...>, std::index_sequence<Is...>, Allocator>
+{
+	using vectors = vectorize_impl<std::tuple<Ts...>, Allocator>;
+
+	using value_type = std::tuple<Ts...>;
+	using allocator_type = Allocator;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = std::tuple<Ts &...>;
+	using const_reference = std::tuple<const Ts &...>;
+	using pointer = std::tuple<Ts *...>;
+	using const_pointer = std::tuple<const Ts *...>;
+	using iterator = typename vectors::iterator;
+	using const_iterator = typename vectors::const_iterator;
+	using reverse_iterator = typename vectors::reverse_iterator;
+	using const_reverse_iterator = typename vectors::const_reverse_iterator;
+
+	typename vectors::type columns;
+
+	column_vectors() = default;
+
+	explicit column_vectors(const Allocator &alloc)
+		: columns{std::tuple_element_t<Is, typename vectors::allocator_type>(alloc)...}
+	{
+	}
+
+	column_vectors(const column_vectors &that, const Allocator &alloc)
+		: columns{std::tuple_element_t<Is, typename vectors::type>(
+			std::get<Is>(that.columns), std::tuple_element_t<Is, typename vectors::allocator_type>(alloc))...}
+	{
+	}
+
+	column_vectors(column_vectors &&that, const Allocator &alloc)
+		: columns{std::tuple_element_t<Is, typename vectors::type>(
+			std::move(std::get<Is>(that.columns)), std::tuple_element_t<Is, typename vectors::allocator_type>(alloc))...}
+	{
+	}
+
+	[[nodiscard]]
+	auto get_allocator() const noexcept -> allocator_type
+	{
+		return allocator_type(std::get<0>(columns).get_allocator());
+	}
+
+	template <std::size_t I>
+	[[nodiscard]]
+	auto column() noexcept -> auto&
+	{
+		return std::get<I>(columns);
+	}
+
+	template <std::size_t I>
+	[[nodiscard]]
+	auto column() const noexcept -> const auto&
+	{
+		return std::get<I>(columns);
+	}
+
+	[[nodiscard]]
+	bool empty() const noexcept
+	{
+		return (... && std::empty(std::get<Is>(columns)));
+	}
+
+	[[nodiscard]]
+	auto size() const noexcept -> size_type
+	{
+		return std::size(std::get<0>(columns));
+	}
 
-template <typename T>
-using vectorize_t = typename vectorize<T>::type;
+	[[nodiscard]]
+	auto max_size() const noexcept -> size_type
+	{
+		return std::min({std::get<Is>(columns).max_size()...});
+	}
+
+	[[nodiscard]]
+	auto capacity() const noexcept -> size_type
+	{
+		return std::min({std::get<Is>(columns).capacity()...});
+	}
+
+	void reserve(const size_type new_cap)
+	{
+		(..., std::get<Is>(columns).reserve(new_cap));
+	}
+
+	void shrink_to_fit()
+	{
+		(..., std::get<Is>(columns).shrink_to_fit());
+	}
+
+	void clear() noexcept
+	{
+		(..., std::get<Is>(columns).clear());
+	}
+
+	template <typename U>
+	void insert(const size_type pos, U &&value)
+	{
+		(..., std::get<Is>(columns).insert(std::begin(std::get<Is>(columns)) + pos,
+		                                  std::get<Is>(std::forward<U>(value))));
+	}
+
+	void insert(const size_type pos, const size_type count, const value_type &value)
+	{
+		(..., std::get<Is>(columns).insert(std::begin(std::get<Is>(columns)) + pos, count, std::get<Is>(value)));
+	}
+
+	template <typename...Args>
+	void emplace(const size_type pos, Args &&...args)
+	{
+		(..., std::apply(
+			[&](auto &&...xs)
+			{
+				std::get<Is>(columns).emplace(std::begin(std::get<Is>(columns)) + pos,
+				                              std::forward<decltype(xs)>(xs)...);
+			}, std::forward<Args>(args)));
+	}
+
+	void erase(const size_type first, const size_type last)
+	{
+		(..., std::get<Is>(columns).erase(std::begin(std::get<Is>(columns)) + first,
+		                                 std::begin(std::get<Is>(columns)) + last));
+	}
+
+	template <typename U>
+	void push_back(U &&value)
+	{
+		(..., std::get<Is>(columns).push_back(std::get<Is>(std::forward<U>(value))));
+	}
+
+	template <typename...Args>
+	auto emplace_back(Args &&...args) -> reference
+	{
+		return {
+			std::apply(
+				[&](auto &&...xs) -> auto&
+				{
+					return std::get<Is>(columns).emplace_back(std::forward<decltype(xs)>(xs)...);
+				}, std::forward<Args>(args))
+			...
+		};
+	}
+
+	// appends n elements to every column, column I copied from firsts[I]; on failure every column
+	// is cut back to its old size
+	template <typename... Its>
+	void append(const size_type n, Its... firsts)
+	{
+		const auto old_size = size();
+		try
+		{
+			(..., std::get<Is>(columns).insert(std::end(std::get<Is>(columns)), firsts, std::next(firsts, n)));
+		}
+		catch (...)
+		{
+			(..., std::get<Is>(columns).erase(std::begin(std::get<Is>(columns)) + old_size, std::end(std::get<Is>(columns))));
+			throw;
+		}
+	}
+
+	void pop_back()
+	{
+		(..., std::get<Is>(columns).pop_back());
+	}
+
+	void resize(const size_type count)
+	{
+		(..., std::get<Is>(columns).resize(count));
+	}
+
+	void resize(const size_type count, const value_type &value)
+	{
+		(..., std::get<Is>(columns).resize(count, std::get<Is>(value)));
+	}
+
+	void swap(column_vectors &other) noexcept
+	{
+		columns.swap(other.columns);
+	}
+};
+} // namespace impl
 } // namespace soa
 
 #endif // SOA_VECTORIZE_H
@@ -1,9 +1,32 @@
 #include <algorithm>
+#include <atomic>
+#include <filesystem>
 #include <iostream>
 #include <iterator>
+#include <memory_resource>
+#include <stdexcept>
+#include <thread>
 #include <tuple>
+#include <vector>
 
+#include "aos.h"
+#include "chunked_struct_array.h"
+#include "column_file.h"
+#include "compact.h"
+#include "compressed_struct_array.h"
+#include "concurrent_struct_array.h"
+#include "fields.h"
+#include "indexed_struct_array.h"
+#include "parallel.h"
+#include "query.h"
+#include "shared_struct_array.h"
+#include "simd.h"
+#include "sort.h"
+#include "stats.h"
+#include "stream.h"
 #include "struct_array.h"
+#include "struct_array_view.h"
+#include "struct_slot_map.h"
 
 struct foo
 {
@@ -15,6 +38,13 @@ struct bar
 	int x, y;
 };
 
+struct baz
+{
+	int a, b, c, d, e, f, g, h;
+};
+
+SOA_FIELDS(baz, a, b, c, d, e, f, g, h)
+
 int main()
 {
 	soa::struct_array<foo> sf;
@@ -72,4 +102,302 @@ int main()
 	for (const auto &[x, y] : sb1)
 		std::cout << '(' << x << ',' << y << ')' << ' ';
 	std::cout << "}\n";
+
+	soa::struct_array<bar, soa::layout::block<>> sbb;
+	sbb.reserve(4);
+	for (auto i = 0; i < 10; ++i)
+		sbb.push_back(bar{i, 10 - i});
+	sbb.erase(std::begin(sbb) + 2, std::begin(sbb) + 4);
+	sbb.insert(std::begin(sbb) + 2, bar{-1, -1});
+
+	std::cout << "sbb block:\n{ ";
+	for (const auto &[x, y] : sbb)
+		std::cout << '(' << x << ',' << y << ')' << ' ';
+	std::cout << "}\n";
+
+	soa::struct_array<bar, soa::layout::aosoa<4>> sbt;
+	for (auto i = 0; i < 10; ++i)
+		sbt.push_back(bar{i, 10 - i});
+	sbt.erase(std::begin(sbt) + 2, std::begin(sbt) + 4);
+	sbt.insert(std::begin(sbt) + 2, bar{-1, -1});
+
+	std::cout << "sbt aosoa:\n{ ";
+	for (const auto &[x, y] : sbt)
+		std::cout << '(' << x << ',' << y << ')' << ' ';
+	std::cout << "} capacity=" << sbt.capacity() << '\n';
+
+	std::byte frame[1024];
+	std::pmr::monotonic_buffer_resource arena{frame, sizeof(frame), std::pmr::null_memory_resource()};
+	soa::pmr::struct_array<bar, soa::layout::block<>> sba{&arena};
+	sba.reserve(8);
+	for (auto i = 0; i < 8; ++i)
+		sba.push_back(bar{i, i * i});
+
+	std::cout << "sba arena:\n{ ";
+	for (const auto &[x, y] : sba)
+		std::cout << '(' << x << ',' << y << ')' << ' ';
+	std::cout << "}\n";
+
+	const auto file = std::filesystem::temp_directory_path() / "struct_array_test.soa";
+	soa::save_columns(file, sbb);
+	{
+		const soa::mapped_struct_array<bar> mapped{file};
+		std::cout << "sbb mapped:\n{ ";
+		for (const auto &[x, y] : mapped)
+			std::cout << '(' << x << ',' << y << ')' << ' ';
+		std::cout << "}\n";
+	}
+	std::filesystem::remove(file);
+
+	const soa::struct_array_view<const bar> sbv = sbb;
+	std::cout << "sbb subview:\n{ ";
+	for (const auto &[x, y] : sbv.subview(2, 3))
+		std::cout << '(' << x << ',' << y << ')' << ' ';
+	std::cout << "}\n";
+
+	const std::vector<bar> aos{{20, 21}, {22, 23}, {24, 25}};
+	const std::vector<int> xs{30, 32}, ys{31, 33};
+	sbb.append(std::begin(aos), std::end(aos));
+	sbb.append_columns(xs, ys);
+
+	std::cout << "sbb appended:\n{ ";
+	for (const auto &[x, y] : sbb)
+		std::cout << '(' << x << ',' << y << ')' << ' ';
+	std::cout << "}\n";
+
+	const auto gathered = [&]
+	{
+		std::vector<bar> result(2);
+		soa::gather(sbb, std::vector{4U, 0U}, std::data(result));
+		return result;
+	}();
+	std::cout << "sbb to_aos:\n{ ";
+	for (const auto &[x, y] : soa::to_aos(sbb))
+		std::cout << '(' << x << ',' << y << ')' << ' ';
+	for (const auto &[x, y] : gathered)
+		std::cout << '[' << x << ',' << y << ']' << ' ';
+	std::cout << "}\n";
+
+	std::cout << "sbb y projected:\n{ ";
+	for (const auto &[y] : sbb.columns<&bar::y>())
+		std::cout << y << ' ';
+	std::cout << "}\n";
+
+	soa::simd::transform<0, 0, 1>(sbb, [](const auto x, const auto y) noexcept { return x + y; });
+	std::cout << "sbb x + y:\n{ sum=" << soa::simd::sum<0>(sbb) << " min=" << soa::simd::min<0>(sbb)
+		<< " max=" << soa::simd::max<0>(sbb) << " dot=" << soa::simd::dot<0, 1>(sbb)
+		<< " odd=" << soa::simd::count_if<0>(sbb, [](const auto x) noexcept { return (x & 1) == 1; }) << " }\n";
+
+	soa::sort(std::execution::par, sb0, [](const auto &lhs, const auto &rhs) noexcept
+	{
+		return std::get<0>(lhs) < std::get<0>(rhs);
+	});
+	soa::for_each<1>(std::execution::par, sb0, [](auto &y) noexcept { y = -y; });
+
+	std::cout << "sb0 parallel sorted:\n{ ";
+	for (const auto &[x, y] : sb0)
+		std::cout << '(' << x << ',' << y << ')' << ' ';
+	std::cout << "} sum=" << soa::reduce<0>(std::execution::par, sb0, 0) << '\n';
+
+	soa::thread_pool pool{4};
+	std::atomic<int> nested{0};
+	pool.run(8, [&](std::size_t)
+	{
+		pool.run(8, [&](std::size_t) { ++nested; });
+	});
+	std::cout << "pool nested tasks: " << nested << '\n';
+
+	soa::stable_sort_by<1>(sb0, std::greater<>{});
+	soa::sort_by(sb1, [](const auto &v) noexcept { return std::get<0>(v) % 3; });
+
+	std::cout << "sb0 sorted by y:\n{ ";
+	for (const auto &[x, y] : sb0)
+		std::cout << '(' << x << ',' << y << ')' << ' ';
+	std::cout << "}\n";
+
+	std::cout << "sb1 sorted by x % 3:\n{ ";
+	for (const auto &[x, y] : sb1)
+		std::cout << '(' << x << ',' << y << ')' << ' ';
+	std::cout << "}\n";
+
+	soa::struct_slot_map<bar> ssm;
+	const auto h0 = ssm.insert(bar{0, 0});
+	const auto h1 = ssm.insert(bar{1, 1});
+	ssm.insert(bar{2, 2});
+	ssm.erase(h0);
+	std::get<1>(ssm[h1]) = 10;
+
+	std::cout << "ssm slot map:\n{ ";
+	for (const auto &[x, y] : ssm)
+		std::cout << '(' << x << ',' << y << ')' << ' ';
+	std::cout << "} stale=" << !ssm.contains(h0) << '\n';
+
+	soa::struct_array<bar> sbe;
+	for (int i = 0; i < 10; ++i)
+		sbe.push_back(bar{i, i * i});
+	const auto erased = soa::erase_if<0>(sbe, [](const auto x) noexcept { return x % 3 == 0; });
+	const auto small = soa::partition<1>(sbe, [](const auto y) noexcept { return y < 20; });
+
+	std::cout << "sbe erase_if x % 3 == 0, partition y < 20:\n{ ";
+	for (const auto &[x, y] : sbe)
+		std::cout << '(' << x << ',' << y << ')' << ' ';
+	std::cout << "} erased=" << erased << " small=" << small << '\n';
+
+	soa::chunked_struct_array<bar, 4> scb;
+	for (int i = 0; i < 10; ++i)
+		scb.push_back(bar{i, 2 * i});
+	scb.erase(std::begin(scb) + 1);
+
+	std::cout << "scb chunked:\n{ ";
+	soa::for_each_segment(std::as_const(scb), [](const auto segment)
+	{
+		std::cout << '[';
+		for (const auto &[x, y] : segment)
+			std::cout << '(' << x << ',' << y << ')';
+		std::cout << "] ";
+	});
+	std::cout << "} capacity=" << scb.capacity() << '\n';
+
+	// the rows stay where they are, iterators have to be retaken from the new owner
+	const auto *const kept = &std::get<0>(scb[2]);
+	const auto scm = std::move(scb);
+	const auto &[mx, my] = *std::begin(scm);
+	std::cout << "scm moved: same row=" << (kept == &std::get<0>(scm[2])) << " first=(" << mx << ',' << my
+		<< ") size=" << std::size(scm) << '\n';
+
+	soa::struct_array<bar> sbz;
+	for (int i = 0; i < 3000; ++i)
+		sbz.push_back(bar{1000 + i, i / 1000});
+	const soa::compressed_struct_array<bar> cz{sbz};
+	long long zsum = 0;
+	cz.for_each_block<0>([&](const auto &block) { zsum += soa::simd::sum<0>(block); });
+
+	std::cout << "cz compressed:\n{ rows=" << std::size(cz) << " bytes=" << cz.bytes()
+		<< " x=" << std::get<0>(cz[2999]) << " y=" << std::get<1>(cz[2999])
+		<< " sum=" << zsum << " y==1: " << cz.between<1>(1, 1).count() << " }\n";
+
+	soa::concurrent_struct_array<bar, 4> ccb{16};
+	{
+		std::vector<std::jthread> producers;
+		for (int t = 0; t < 2; ++t)
+			producers.emplace_back([&ccb, t]
+			{
+				for (int i = 0; i < 5; ++i)
+					ccb.push_back(bar{t, i});
+			});
+	}
+	auto sealed = ccb.seal();
+	std::sort(std::begin(sealed), std::end(sealed), [](const auto &lhs, const auto &rhs) noexcept
+	{
+		const auto &[x0, y0] = lhs;
+		const auto &[x1, y1] = rhs;
+		return x0 < x1 || (x0 == x1 && y0 < y1);
+	});
+
+	std::cout << "ccb concurrent, sealed and sorted:\n{ ";
+	for (const auto &[x, y] : sealed)
+		std::cout << '(' << x << ',' << y << ')' << ' ';
+	std::cout << "} left=" << std::size(ccb) << '\n';
+
+	soa::concurrent_struct_array<bar, 4> cce{4};
+	for (int i = 0; i < 3; ++i)
+		cce.push_back(bar{i, i});
+	const std::vector<bar> overflow{bar{3, 3}, bar{4, 4}};
+	try
+	{
+		cce.append(std::begin(overflow), std::end(overflow));
+	}
+	catch (const std::length_error &)
+	{
+		std::cout << "cce exhausted at " << std::size(cce);
+	}
+	cce.reserve(16);
+	cce.append(std::begin(overflow), std::end(overflow));
+	cce.push_back(bar{5, 5});
+	std::cout << ", after reserve size=" << std::size(cce) << '\n';
+
+	soa::struct_array<baz> sz;
+	for (int i = 0; i < 4; ++i)
+		sz.push_back(baz{i, i, i, i, i, i, i, 10 * i});
+
+	std::cout << "sz described:\n{ ";
+	for (std::size_t i = 0U; i < soa::fields<baz>::count; ++i)
+		std::cout << soa::fields<baz>::names[i] << '@' << soa::fields<baz>::offsets[i] << ' ';
+	std::cout << "} h: { ";
+	for (const auto h : sz.column<"h">())
+		std::cout << h << ' ';
+	std::cout << "}\n";
+
+	soa::struct_array<baz, soa::layout::grouped<soa::group<0, 1, 2>, soa::group<&baz::h, &baz::d>>> sg;
+	for (int i = 0; i < 4; ++i)
+		sg.push_back(baz{i, 2 * i, 3 * i, 4 * i, 0, 0, 0, 5 * i});
+	sg.erase(std::begin(sg) + 1);
+
+	std::cout << "sg grouped:\n{ ";
+	for (const auto &[a, b, c] : sg.project<0, 1, 2>())
+		std::cout << '(' << a << ',' << b << ',' << c << ')' << ' ';
+	std::cout << "} h: { ";
+	for (const auto h : sg.column<"h">())
+		std::cout << h << ' ';
+	std::cout << "}\n";
+
+	soa::struct_array<bar> sq;
+	for (int i = 0; i < 10; ++i)
+		sq.push_back(bar{i, i % 3});
+
+	namespace query = soa::query;
+	const auto hits = query::select(sq, query::col<0> >= 2 && !(query::col<1> == 0));
+	const auto [total, matched] = query::aggregate(sq, hits, query::sum<0>, query::count);
+
+	std::cout << "sq query:\n{ rows: ";
+	for (const auto i : query::rows(hits))
+		std::cout << i << ' ';
+	std::cout << "sum=" << total << " count=" << matched << " } by y: { ";
+	for (const auto &[y, result] : query::group_by<1>(sq, hits, query::count, query::max<0>))
+		std::cout << y << ':' << std::get<0>(result) << '/' << std::get<1>(result) << ' ';
+	std::cout << "}\n";
+
+	soa::indexed_struct_array<bar, std::tuple<soa::hash_index<bar, 1>, soa::sorted_index<bar, 0>, soa::zone_map<bar, 0, 4>>> si;
+	for (int i = 0; i < 12; ++i)
+		si.push_back(bar{3 * i, i % 4});
+	si.erase(std::begin(si) + 2);
+	si.modify(0, [](auto &&row) { std::get<1>(row) = 2; });
+
+	std::cout << "si indexed:\n{ y==2: ";
+	for (const auto i : si.find<0>(2))
+		std::cout << i << ' ';
+	std::cout << "9<=x<=21: ";
+	for (const auto i : si.find<1>(9, 21))
+		std::cout << i << ' ';
+	std::cout << "blocks=" << si.index<2>().blocks() << " x>30: " << si.find<2>(31, 99).count() << " }\n";
+
+	soa::struct_array<bar> sw;
+	for (int i = 0; i < 1000; ++i)
+		sw.push_back(bar{i, 0});
+	soa::stream_transform<1, 0>(sw, [](const auto x) noexcept { return x * 3; }, {.tile_bytes = 1024U});
+	soa::stream_for_each<0, 1>(std::execution::par, sw, [](const int x, int &y) noexcept { y -= x; });
+	std::cout << "sw streamed:\n{ sum=" << soa::simd::sum<1>(sw) << " }\n";
+
+	soa::shared_struct_array<bar> sc;
+	for (int i = 0; i < 5; ++i)
+		sc.push_back(bar{i, 10 * i});
+	const auto report = soa::snapshot(sc);
+	sc.column<&bar::y>()[0] = -1;
+	sc.push_back(bar{5, 50});
+
+	std::cout << "sc snapshot:\n{ ";
+	for (const auto &[x, y] : report)
+		std::cout << '(' << x << ',' << y << ')' << ' ';
+	std::cout << "} size=" << std::size(sc) << " y[0]=" << std::get<1>(std::as_const(sc)[0]) << '\n';
+
+#if SOA_STATS
+	soa::struct_array<baz> ss;
+	for (int i = 0; i < 100; ++i)
+		ss.push_back(baz{i, 0, 0, 0, 0, 0, 0, i});
+	ss.erase(std::begin(ss));
+	for (const auto h : ss.column<"h">())
+		static_cast<void>(h);
+
+	std::cout << "ss stats:\n" << soa::to_json(soa::stats_of(ss)) << '\n';
+#endif
 }